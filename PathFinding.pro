@@ -2,16 +2,71 @@ QT      += charts core gui concurrent testlib
 
 CONFIG += c++17
 
+# qmake CONFIG+=nostats compiles the search counters out
+nostats: DEFINES += PATHFINDING_NO_STATS
+
 SOURCES += \
+    sources/BatchRunner.cpp \
+    sources/BitParallelBfs.cpp \
+    sources/ComponentIndex.cpp \
+    sources/ContractionHierarchy.cpp \
+    sources/DatasetGenerator.cpp \
+    sources/FlowField.cpp \
+    sources/GridGenerator.cpp \
+    sources/GridIO.cpp \
     sources/GridView.cpp \
+    sources/HierarchicalPlanner.cpp \
+    sources/IncrementalPlanner.cpp \
+    sources/JobExecutor.cpp \
+    sources/LandmarkPlanner.cpp \
+    sources/LineOfSight.cpp \
+    sources/LocalSearch.cpp \
+    sources/MultiAgentPlanner.cpp \
+    sources/MazeFeatures.cpp \
     sources/MazeGenerator.cpp \
     sources/PathAlgorithm.cpp \
+    sources/RaceView.cpp \
+    sources/SearchEngine.cpp \
+    sources/SearchKernel.cpp \
+    sources/SearchTiming.cpp \
+    sources/SparseCellMap.cpp \
+    sources/TerrainCost.cpp \
+    sources/ThetaStar.cpp \
+    sources/TraceEvents.cpp \
+    sources/TrialRunner.cpp \
     sources/main.cpp \
     sources/mainWindow.cpp
 
 HEADERS += \
+    headers/BatchRunner.h \
+    headers/BitParallelBfs.h \
+    headers/CellLayout.h \
+    headers/ComponentIndex.h \
+    headers/ContractionHierarchy.h \
+    headers/DatasetGenerator.h \
+    headers/FlowField.h \
+    headers/Grid.h \
+    headers/GridGenerator.h \
+    headers/GridIO.h \
     headers/GridView.h \
+    headers/HierarchicalPlanner.h \
+    headers/IncrementalPlanner.h \
+    headers/JobExecutor.h \
+    headers/LandmarkPlanner.h \
+    headers/LineOfSight.h \
+    headers/LocalSearch.h \
+    headers/MazeFeatures.h \
+    headers/MultiAgentPlanner.h \
     headers/PathAlgorithm.h \
+    headers/RaceView.h \
+    headers/SearchEngine.h \
+    headers/SearchKernel.h \
+    headers/SearchTiming.h \
+    headers/SparseCellMap.h \
+    headers/TerrainCost.h \
+    headers/ThetaStar.h \
+    headers/TraceEvents.h \
+    headers/TrialRunner.h \
     headers/mainWindow.h
 
 FORMS += \
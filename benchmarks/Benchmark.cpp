@@ -0,0 +1,162 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <thread>
+
+namespace {
+
+struct Registered
+{
+    std::string name;
+    std::function<void(BenchmarkState&)> body;
+};
+
+std::vector<Registered>& registry()
+{
+    static std::vector<Registered> benchmarks;
+    return benchmarks;
+}
+
+struct Report
+{
+    std::string name;
+    long long iterations = 0;
+    double medianNs = 0.0;          // per iteration
+    double minNs = 0.0;
+    double itemsPerSecond = 0.0;
+    std::map<std::string, double> counters;
+};
+
+std::string jsonEscape(const std::string& text)
+{
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+void writeJson(const std::vector<Report>& reports, const BenchmarkOptions& options, std::ostream& json)
+{
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    json << "{\n  \"context\": {\n"
+         << "    \"date\": \"" << date << "\",\n"
+         << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+#ifdef NDEBUG
+         << "    \"library_build_type\": \"release\",\n"
+#else
+         << "    \"library_build_type\": \"debug\",\n"
+#endif
+         << "    \"repetitions\": " << options.repetitions << ",\n"
+         << "    \"min_time\": " << options.minSeconds << "\n"
+         << "  },\n  \"benchmarks\": [";
+    json << std::setprecision(12);
+    for (size_t i = 0; i < reports.size(); ++i) {
+        const Report& report = reports[i];
+        json << (i ? ",\n" : "\n") << "    {\n"
+             << "      \"name\": \"" << jsonEscape(report.name) << "\",\n"
+             << "      \"iterations\": " << report.iterations << ",\n"
+             << "      \"real_time\": " << report.medianNs << ",\n"
+             << "      \"min_real_time\": " << report.minNs << ",\n"
+             << "      \"time_unit\": \"ns\"";
+        if (report.itemsPerSecond > 0)
+            json << ",\n      \"items_per_second\": " << report.itemsPerSecond;
+        for (const auto& counter : report.counters)
+            json << ",\n      \"" << jsonEscape(counter.first) << "\": " << counter.second;
+        json << "\n    }";
+    }
+    json << "\n  ]\n}\n";
+}
+
+} // namespace
+
+bool BenchmarkState::keepRunning()
+{
+    auto now = std::chrono::steady_clock::now();
+    if (!started) {
+        started = true;
+        since = now;
+        return true;
+    }
+    iterationCount++;
+    if (!paused) {
+        timedNs += std::chrono::duration_cast<std::chrono::nanoseconds>(now - since).count();
+        since = now;
+    }
+    if (timedNs < minNs) return true;
+    paused = true;
+    return false;
+}
+
+void BenchmarkState::pauseTiming()
+{
+    if (paused) return;
+    timedNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now() - since).count();
+    paused = true;
+}
+
+void BenchmarkState::resumeTiming()
+{
+    if (!paused) return;
+    paused = false;
+    since = std::chrono::steady_clock::now();
+}
+
+void registerBenchmark(const std::string& name, std::function<void(BenchmarkState&)> body)
+{
+    registry().push_back({name, std::move(body)});
+}
+
+int runBenchmarks(const BenchmarkOptions& options, std::ostream& out)
+{
+    std::vector<Report> reports;
+    out << std::left << std::setw(48) << "Benchmark" << std::right << std::setw(16) << "Time (ns)"
+        << std::setw(16) << "Min (ns)" << std::setw(12) << "Iterations" << "\n";
+
+    for (const Registered& benchmark : registry()) {
+        if (!options.filter.empty() && benchmark.name.find(options.filter) == std::string::npos) continue;
+
+        std::vector<double> perIteration;
+        Report report;
+        report.name = benchmark.name;
+        for (int rep = 0; rep < std::max(1, options.repetitions); ++rep) {
+            BenchmarkState state(options.minSeconds);
+            benchmark.body(state);
+            if (state.iterations() == 0) continue;
+            const double ns = static_cast<double>(state.elapsedNs()) / state.iterations();
+            perIteration.push_back(ns);
+            report.iterations += state.iterations();
+            report.counters = state.counters();
+            if (state.itemsPerIteration() > 0 && ns > 0)
+                report.itemsPerSecond = state.itemsPerIteration() / (ns / 1e9);
+        }
+        if (perIteration.empty()) continue;
+
+        std::sort(perIteration.begin(), perIteration.end());
+        report.medianNs = perIteration[perIteration.size() / 2];
+        report.minNs = perIteration.front();
+        reports.push_back(report);
+
+        out << std::left << std::setw(48) << report.name << std::right << std::fixed << std::setprecision(0)
+            << std::setw(16) << report.medianNs << std::setw(16) << report.minNs
+            << std::setw(12) << report.iterations << "\n";
+        out.flush();
+    }
+
+    if (!options.jsonFile.empty()) {
+        std::ofstream json(options.jsonFile);
+        if (!json) {
+            out << "Cannot write " << options.jsonFile << "\n";
+            return 1;
+        }
+        writeJson(reports, options, json);
+    }
+    return 0;
+}
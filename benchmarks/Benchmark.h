@@ -0,0 +1,71 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Small harness in the style of Google Benchmark, so the suite builds with
+// nothing but the project sources. A benchmark body sets up its data, then
+// loops on keepRunning(); only the loop is timed. Results are written in
+// Google Benchmark's JSON layout, so compare_benchmarks.py reads either.
+class BenchmarkState
+{
+public:
+    explicit BenchmarkState(double minSeconds) : minNs(static_cast<long long>(minSeconds * 1e9)) {}
+
+    // True until at least minSeconds of timed work and one iteration are done
+    bool keepRunning();
+
+    // Leave per-iteration setup out of the measurement
+    void pauseTiming();
+    void resumeTiming();
+
+    void setItemsPerIteration(long long items) { itemCount = items; }
+    void setCounter(const std::string& name, double value) { userCounters[name] = value; }
+
+    long long iterations() const { return iterationCount; }
+    long long elapsedNs() const { return timedNs; }
+    long long itemsPerIteration() const { return itemCount; }
+    const std::map<std::string, double>& counters() const { return userCounters; }
+
+private:
+    long long minNs;
+    long long iterationCount = 0;
+    long long timedNs = 0;
+    long long itemCount = 0;
+    bool started = false;
+    bool paused = false;
+    std::chrono::steady_clock::time_point since;
+    std::map<std::string, double> userCounters;
+};
+
+// Keeps the compiler from dropping a computation whose result is unused
+template <class T>
+inline void doNotOptimize(const T& value)
+{
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+struct BenchmarkOptions
+{
+    std::string filter;             // substring of the names to run, empty runs all
+    std::string jsonFile;           // empty: table on stdout only
+    double minSeconds = 0.2;        // timed work per repetition
+    int repetitions = 3;            // the report keeps the median and the minimum
+};
+
+void registerBenchmark(const std::string& name, std::function<void(BenchmarkState&)> body);
+
+// Runs the registered benchmarks in registration order. Returns the exit code.
+int runBenchmarks(const BenchmarkOptions& options, std::ostream& out);
+
+#endif // BENCHMARK_H
@@ -0,0 +1,297 @@
+#include "Benchmark.h"
+#include "Grid.h"
+#include "GridGenerator.h"
+#include "MazeFeatures.h"
+#include "SearchEngine.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+
+// Benchmark suite for the headless solvers and generators:
+//   pathfinding_bench [--filter text] [--json file] [--min-time s] [--repetitions n]
+//                     [--sizes 32,128,...] [--densities 0.1,...] [--seeds 1,2,...]
+//                     [--check-allocations]
+// Compare two JSON files with compare_benchmarks.py. --check-allocations
+// fails when a repeated query through a SearchContext allocates.
+
+// Every heap allocation of the program is counted, so the query benchmarks
+// can report allocations per query
+static std::atomic<long long> heapAllocations{0};
+
+// GCC pairs the inlined free() below with operator new and warns, although
+// both sides are the replacements defined here
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size)
+{
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+namespace {
+
+struct SuiteOptions
+{
+    std::vector<int> sizes = {32, 128, 512, 2048, 8192};
+    std::vector<double> densities = {0.1, 0.25, 0.4};
+    std::vector<int> seeds = {1, 2, 3};
+    // Node grids take about 80 bytes a cell, larger copies would not fit in memory
+    int maxNodeGridSize = 2048;
+    bool checkAllocations = false;
+};
+
+template <class T>
+std::vector<T> parseList(const char* text)
+{
+    std::vector<T> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+        values.push_back(static_cast<T>(std::atof(item.c_str())));
+    return values;
+}
+
+bool parseOptions(int argc, char** argv, BenchmarkOptions& harness, SuiteOptions& suite)
+{
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--filter") && hasValue) harness.filter = argv[++i];
+        else if (!std::strcmp(argv[i], "--json") && hasValue) harness.jsonFile = argv[++i];
+        else if (!std::strcmp(argv[i], "--min-time") && hasValue) harness.minSeconds = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--repetitions") && hasValue) harness.repetitions = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--sizes") && hasValue) suite.sizes = parseList<int>(argv[++i]);
+        else if (!std::strcmp(argv[i], "--densities") && hasValue) suite.densities = parseList<double>(argv[++i]);
+        else if (!std::strcmp(argv[i], "--seeds") && hasValue) suite.seeds = parseList<int>(argv[++i]);
+        else if (!std::strcmp(argv[i], "--check-allocations")) suite.checkAllocations = true;
+        else {
+            std::cerr << "Unknown option " << argv[i] << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// Square grid with the start and end in opposite corners, as the grid view sets them
+GridSnapshot squareGrid(int size)
+{
+    GridSnapshot snapshot;
+    snapshot.width = size;
+    snapshot.height = size;
+    snapshot.startIndex = 0;
+    snapshot.endIndex = size * size - 1;
+    snapshot.obstacle.assign(snapshot.cellCount(), 0);
+    return snapshot;
+}
+
+GridSnapshot randomGrid(int size, double density, int seed)
+{
+    GridSnapshot snapshot = squareGrid(size);
+    scatterObstacles(snapshot, static_cast<float>(density), static_cast<uint32_t>(seed));
+    return snapshot;
+}
+
+// The GUI's grid of nodes, as copied into PathAlgorithm and each stepper
+grid nodeGrid(const GridSnapshot& snapshot)
+{
+    grid nodes;
+    nodes.Nodes.resize(snapshot.cellCount());
+    for (int idx = 0; idx < snapshot.cellCount(); ++idx) {
+        nodes.Nodes[idx].xCoord = idx % snapshot.width + 1;
+        nodes.Nodes[idx].yCoord = idx / snapshot.width + 1;
+        nodes.Nodes[idx].obstacle = snapshot.obstacle[idx] != 0;
+    }
+    nodes.startIndex = snapshot.startIndex;
+    nodes.endIndex = snapshot.endIndex;
+    nodes.currentIndex = snapshot.startIndex;
+    return nodes;
+}
+
+std::string caseName(const char* benchmark, int size, double density, int seed)
+{
+    char name[96];
+    std::snprintf(name, sizeof(name), "%s/%d/density:%.2f/seed:%d", benchmark, size, density, seed);
+    return name;
+}
+
+void registerSuite(const SuiteOptions& suite)
+{
+    for (int size : suite.sizes) {
+        for (double density : suite.densities) {
+            for (int seed : suite.seeds) {
+                // Corner to corner; an unreachable goal floods the start's region instead
+                registerBenchmark(caseName("dijkstra", size, density, seed), [=](BenchmarkState& state) {
+                    GridSnapshot snapshot = randomGrid(size, density, seed);
+                    const SolverEntry& dijkstra = *findSolver("Dijkstra");
+                    SearchContext context;
+                    context.run(dijkstra, snapshot, snapshot.startIndex, snapshot.endIndex);
+                    const long long allocationsBefore = heapAllocations.load(std::memory_order_relaxed);
+                    long long queries = 0;
+                    while (state.keepRunning()) {
+                        doNotOptimize(context.run(dijkstra, snapshot, snapshot.startIndex, snapshot.endIndex).nodesVisited);
+                        queries++;
+                    }
+                    const long long allocations = heapAllocations.load(std::memory_order_relaxed) - allocationsBefore;
+                    const SearchResult& result = context.result();
+                    state.setItemsPerIteration(result.nodesVisited);
+                    state.setCounter("nodes_visited", result.nodesVisited);
+                    state.setCounter("path_length", result.pathLength);
+                    state.setCounter("allocations_per_query", queries == 0 ? 0.0 : static_cast<double>(allocations) / queries);
+                });
+
+                registerBenchmark(caseName("features", size, density, seed), [=](BenchmarkState& state) {
+                    GridSnapshot snapshot = randomGrid(size, density, seed);
+                    MazeFeatureIndex features;
+                    while (state.keepRunning()) {
+                        features.build(snapshot);
+                        doNotOptimize(features.deadEnds());
+                    }
+                    state.setItemsPerIteration(snapshot.cellCount());
+                });
+            }
+        }
+
+        // Generation and copies do not depend on the obstacle density
+        for (int seed : suite.seeds) {
+            registerBenchmark(caseName("maze", size, 0.0, seed), [=](BenchmarkState& state) {
+                GridSnapshot snapshot = squareGrid(size);
+                uint32_t iterationSeed = static_cast<uint32_t>(seed);
+                while (state.keepRunning()) {
+                    carveMaze(snapshot, iterationSeed++);
+                    doNotOptimize(snapshot.obstacle.data());
+                }
+                state.setItemsPerIteration(snapshot.cellCount());
+            });
+        }
+
+        const int seed = suite.seeds.empty() ? 1 : suite.seeds.front();
+        const double density = suite.densities.empty() ? 0.0 : suite.densities.front();
+
+        // A hop of at most 32 cells from the centre: A* pays for grid-sized
+        // arrays, the local search only for the cells it reaches
+        for (const char* solverName : {"A*", "Local A*"}) {
+            const char* benchmark = solverName[0] == 'L' ? "short_hop_local" : "short_hop_astar";
+            registerBenchmark(caseName(benchmark, size, density, seed), [=](BenchmarkState& state) {
+                GridSnapshot snapshot = randomGrid(size, density, seed);
+                const int hop = std::min(32, size / 4);
+                const int start = (size / 2) * size + size / 2;
+                const int goal = start + hop * size + hop;
+                snapshot.obstacle[start] = 0;
+                snapshot.obstacle[goal] = 0;
+                snapshot.markEdited();
+                const SolverEntry& solver = *findSolver(solverName);
+                SearchContext context;
+                context.run(solver, snapshot, start, goal);
+                while (state.keepRunning())
+                    doNotOptimize(context.run(solver, snapshot, start, goal).nodesVisited);
+                const SearchResult& result = context.result();
+                state.setItemsPerIteration(result.nodesVisited);
+                state.setCounter("nodes_visited", result.nodesVisited);
+                state.setCounter("memory_bytes", static_cast<double>(result.memoryBytes));
+            });
+        }
+
+        // The same hop of an eighth of the grid, with the cells stored
+        // row-major or in tiles; Local A* searches either in place
+        for (CELLLAYOUTS layout : {LAYOUT_ROW_MAJOR, LAYOUT_TILED}) {
+            const char* benchmark = layout == LAYOUT_TILED ? "layout_tiled" : "layout_row_major";
+            registerBenchmark(caseName(benchmark, size, density, seed), [=](BenchmarkState& state) {
+                GridSnapshot snapshot = randomGrid(size, density, seed);
+                const int centre = size / 2;
+                const int hop = std::max(1, size / 8);
+                snapshot.obstacle[centre * size + centre] = 0;
+                snapshot.obstacle[(centre + hop) * size + centre + hop] = 0;
+                snapshot = withLayout(snapshot, layout);
+                const int start = snapshot.cellAt(centre, centre);
+                const int goal = snapshot.cellAt(centre + hop, centre + hop);
+                const SolverEntry& solver = *findSolver("Local A*");
+                SearchContext context;
+                context.run(solver, snapshot, start, goal);
+                while (state.keepRunning())
+                    doNotOptimize(context.run(solver, snapshot, start, goal).nodesVisited);
+                const SearchResult& result = context.result();
+                state.setItemsPerIteration(result.nodesVisited);
+                state.setCounter("nodes_visited", result.nodesVisited);
+                state.setCounter("path_length", result.pathLength);
+            });
+        }
+
+        registerBenchmark(caseName("snapshot_copy", size, density, seed), [=](BenchmarkState& state) {
+            GridSnapshot snapshot = randomGrid(size, density, seed);
+            while (state.keepRunning()) {
+                GridSnapshot copy = snapshot;
+                doNotOptimize(copy.obstacle.data());
+            }
+            state.setItemsPerIteration(snapshot.cellCount());
+        });
+
+        if (size <= suite.maxNodeGridSize) {
+            registerBenchmark(caseName("grid_copy", size, density, seed), [=](BenchmarkState& state) {
+                grid nodes = nodeGrid(randomGrid(size, density, seed));
+                while (state.keepRunning()) {
+                    grid copy = nodes;
+                    doNotOptimize(copy.Nodes.data());
+                }
+                state.setItemsPerIteration(static_cast<long long>(nodes.Nodes.size()));
+            });
+        }
+    }
+}
+
+// Runs every solver a few times on one grid through a SearchContext. The
+// first query sizes the buffers; every later one must not allocate.
+int checkAllocations(std::ostream& out)
+{
+    GridSnapshot snapshot = randomGrid(256, 0.1, 1);
+    const int repeats = 5;
+    int failures = 0;
+    auto report = [&](const std::string& name, long long allocations, int pathLength) {
+        out << std::left << std::setw(24) << name << allocations << " allocation(s) in " << repeats
+            << " repeated queries, path length " << pathLength << (allocations ? "  FAIL" : "") << "\n";
+        failures += allocations != 0;
+    };
+
+    for (const SolverEntry& solver : solverRegistry()) {
+        SearchContext context;
+        context.run(solver, snapshot, snapshot.startIndex, snapshot.endIndex);
+        const long long before = heapAllocations.load(std::memory_order_relaxed);
+        for (int i = 0; i < repeats; ++i)
+            context.run(solver, snapshot, snapshot.startIndex, snapshot.endIndex);
+        report(solver.name, heapAllocations.load(std::memory_order_relaxed) - before, context.result().pathLength);
+    }
+    for (const std::string& name : preparedSolverNames()) {
+        std::unique_ptr<PreparedSolver> solver = createPreparedSolver(name);
+        solver->prepare(snapshot);
+        SearchContext context;
+        context.query(*solver, snapshot.startIndex, snapshot.endIndex);
+        const long long before = heapAllocations.load(std::memory_order_relaxed);
+        for (int i = 0; i < repeats; ++i)
+            context.query(*solver, snapshot.startIndex, snapshot.endIndex);
+        report(name, heapAllocations.load(std::memory_order_relaxed) - before, context.result().pathLength);
+    }
+    return failures ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    BenchmarkOptions harness;
+    SuiteOptions suite;
+    if (!parseOptions(argc, argv, harness, suite)) return 2;
+    if (suite.checkAllocations) return checkAllocations(std::cout);
+    registerSuite(suite);
+    return runBenchmarks(harness, std::cout);
+}
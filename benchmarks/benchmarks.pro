@@ -0,0 +1,40 @@
+# Benchmark suite for the headless solvers and generators, built apart from
+# the application and without Qt:
+#   qmake benchmarks/benchmarks.pro && make
+#   ./pathfinding_bench --json current.json
+#   ./pathfinding_bench --check-allocations
+#   benchmarks/compare_benchmarks.py baseline.json current.json --threshold 5
+
+TEMPLATE = app
+TARGET = pathfinding_bench
+
+CONFIG += console c++17 release
+CONFIG -= qt app_bundle
+DEFINES += NDEBUG
+
+INCLUDEPATH += $$PWD/../headers
+
+SOURCES += \
+    Benchmark.cpp \
+    PathFindingBench.cpp \
+    ../sources/BitParallelBfs.cpp \
+    ../sources/ContractionHierarchy.cpp \
+    ../sources/GridGenerator.cpp \
+    ../sources/HierarchicalPlanner.cpp \
+    ../sources/JobExecutor.cpp \
+    ../sources/LandmarkPlanner.cpp \
+    ../sources/LineOfSight.cpp \
+    ../sources/LocalSearch.cpp \
+    ../sources/MazeFeatures.cpp \
+    ../sources/SearchEngine.cpp \
+    ../sources/SearchKernel.cpp \
+    ../sources/SearchTiming.cpp \
+    ../sources/SparseCellMap.cpp \
+    ../sources/TerrainCost.cpp \
+    ../sources/ThetaStar.cpp
+
+HEADERS += \
+    Benchmark.h
+
+DISTFILES += \
+    compare_benchmarks.py
@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+"""Compares two benchmark JSON files and flags regressions.
+
+    compare_benchmarks.py baseline.json current.json [--threshold 5] [--metric real_time]
+
+Reads the output of pathfinding_bench (or Google Benchmark). A benchmark
+regresses when its time grew by more than the threshold, in percent.
+Exits with 1 when any benchmark regressed, so it can gate a CI step.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path, metric):
+    with open(path) as f:
+        data = json.load(f)
+    times = {}
+    for bench in data.get("benchmarks", []):
+        # Google Benchmark aggregates: keep the median only
+        if bench.get("run_type") == "aggregate" and bench.get("aggregate_name") != "median":
+            continue
+        if metric in bench:
+            times[bench.get("run_name", bench["name"])] = float(bench[metric])
+    return times
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=5.0,
+                        help="allowed slow-down in percent (default 5)")
+    parser.add_argument("--metric", default="real_time",
+                        help="time field to compare: real_time or min_real_time")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline, args.metric)
+    current = load(args.current, args.metric)
+
+    regressions = 0
+    width = max((len(name) for name in current), default=9)
+    print(f"{'Benchmark':<{width}} {'Baseline':>14} {'Current':>14} {'Change':>9}")
+    for name, time in current.items():
+        if name not in baseline:
+            print(f"{name:<{width}} {'-':>14} {time:>14.0f} {'new':>9}")
+            continue
+        before = baseline[name]
+        change = (time - before) / before * 100.0 if before > 0 else 0.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        print(f"{name:<{width}} {before:>14.0f} {time:>14.0f} {change:>+8.1f}%{flag}")
+    for name in baseline:
+        if name not in current:
+            print(f"{name:<{width}} {baseline[name]:>14.0f} {'-':>14} {'missing':>9}")
+
+    if regressions:
+        print(f"\n{regressions} benchmark(s) slower by more than {args.threshold:g}%")
+        return 1
+    print(f"\nNo regressions above {args.threshold:g}%")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,33 @@
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <ostream>
+#include <string>
+#include "HierarchicalPlanner.h"
+
+// Command line options of the headless batch mode
+struct BatchOptions
+{
+    std::string jobFile;
+    std::string solverName = "Dijkstra";
+    int threads = 0;        // 0: one per hardware thread
+    int chunkSize = 64;
+    HierarchyConfig hierarchy;  // used by --solver "HPA*"
+    int landmarks = 8;          // used by --solver ALT
+    bool agents = false;        // plan all jobs together as cooperating agents
+    int agentBatch = 0;         // agents planned in parallel per batch, 0: 8 per thread
+};
+
+// Fills options from "--batch <jobs> [--solver name] [--threads N] [--chunk K]
+// [--cluster-size C] [--levels L] [--landmarks K] [--agents] [--agent-batch B]".
+// Returns false when the program was not started in batch mode.
+bool parseBatchOptions(int argc, char* argv[], BatchOptions& options);
+
+// Job files hold one query per line: "<map file> <startX> <startY> <goalX> <goalY>"
+// with 1-based coordinates as in the GUI. MovingAI .scen files are accepted too.
+// Map paths are relative to the job file. With --agents every job is one agent
+// on a single shared map and the jobs are planned collision-free together.
+// Returns the process exit code.
+int runBatch(const BatchOptions& options, std::ostream& out);
+
+#endif // BATCHRUNNER_H
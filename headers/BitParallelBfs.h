@@ -0,0 +1,17 @@
+#ifndef BITPARALLELBFS_H
+#define BITPARALLELBFS_H
+
+#include "SearchEngine.h"
+
+// Breadth-first search on the 4-connected grid with unit steps, one bit per
+// cell. Free cells, the visited set and the frontier are bit planes with each
+// row packed into 64-bit words, so a whole layer is expanded with shifts, ands
+// and ors (four words per instruction when the CPU has AVX2, detected at
+// run time with GCC and Clang). Only rows next to the frontier are touched.
+// Terrain costs are ignored.
+// Distances are left in scratch.distance for the cells the query stamped
+// (scratch.touched()) and the path is traced back through them, so it
+// matches a Dijkstra path in length.
+SearchResult bitParallelBfs(const GridSnapshot& snapshot, int startIndex, int endIndex, SearchScratch& scratch);
+
+#endif // BITPARALLELBFS_H
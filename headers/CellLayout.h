@@ -0,0 +1,74 @@
+#ifndef CELLLAYOUT_H
+#define CELLLAYOUT_H
+
+#include <algorithm>
+
+// Order of the cells of a GridSnapshot in memory. Row-major puts vertical
+// neighbours a full row apart, so on wide grids every north or south step
+// lands on another cache line and, past a few thousand columns, another
+// page. Tiled stores the grid in 64x64 tiles, tile rows bottom to top and
+// tiles left to right within them, each tile row-major; vertical neighbours
+// inside a tile are 64 cells apart. Tiles on the right and top edges are cut
+// to the grid, so there is no padding and indices stay 0 to width * height - 1.
+typedef enum {
+    LAYOUT_ROW_MAJOR,
+    LAYOUT_TILED
+} CELLLAYOUTS;
+
+const int kTileShift = 6;
+const int kTileSize = 1 << kTileShift;
+
+// Index of (x, y) and its inverse, both 0-based, for each layout
+struct RowMajorLayout
+{
+    int width;
+    int height;
+
+    int index(int x, int y) const { return y * width + x; }
+    void coords(int cell, int& x, int& y) const
+    {
+        y = cell / width;
+        x = cell - y * width;
+    }
+};
+
+struct TiledLayout
+{
+    int width;
+    int height;
+
+    int index(int x, int y) const
+    {
+        const int bandY = y & ~(kTileSize - 1);
+        const int tileX = x & ~(kTileSize - 1);
+        const int bandRows = std::min(kTileSize, height - bandY);
+        const int tileColumns = std::min(kTileSize, width - tileX);
+        return bandY * width + tileX * bandRows + (y - bandY) * tileColumns + (x - tileX);
+    }
+
+    void coords(int cell, int& x, int& y) const
+    {
+        // Every band below the last is kTileSize rows high, every tile left of the last kTileSize wide
+        const int bandY = cell / (width << kTileShift) << kTileShift;
+        const int inBand = cell - bandY * width;
+        if (height - bandY >= kTileSize) {
+            // Full-height band: tiles are kTileSize * kTileSize cells, found with shifts
+            const int tileX = inBand >> (2 * kTileShift) << kTileShift;
+            if (width - tileX >= kTileSize) {
+                const int inTile = inBand & (kTileSize * kTileSize - 1);
+                y = bandY + (inTile >> kTileShift);
+                x = tileX + (inTile & (kTileSize - 1));
+                return;
+            }
+        }
+        const int bandRows = std::min(kTileSize, height - bandY);
+        const int tileX = inBand / (bandRows << kTileShift) << kTileShift;
+        const int inTile = inBand - tileX * bandRows;
+        const int tileColumns = std::min(kTileSize, width - tileX);
+        const int row = inTile / tileColumns;
+        y = bandY + row;
+        x = tileX + inTile - row * tileColumns;
+    }
+};
+
+#endif // CELLLAYOUT_H
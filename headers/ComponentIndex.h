@@ -0,0 +1,52 @@
+#ifndef COMPONENTINDEX_H
+#define COMPONENTINDEX_H
+
+#include <memory>
+#include <vector>
+#include "JobExecutor.h"
+#include "SearchEngine.h"
+
+// Connected-component labelling of the free cells (4-connected), so a query
+// whose start and goal lie in different regions is answered before searching.
+// Built with a scanline union-find over row bands, in parallel on an executor
+// the index keeps for its rebuilds. Opening a cell merges components in
+// place; closing a cell that could split a region only marks the index stale
+// until refresh() relabels it.
+class ComponentIndex
+{
+public:
+    ComponentIndex();
+
+    // Labels every free cell. threads == 0 uses one thread per hardware thread.
+    void build(const GridSnapshot& snapshot, int threads = 0);
+    bool isBuilt() const;
+    void clear();
+
+    // Keeps the index in sync with a single cell edit
+    void setObstacle(int index, bool obstacle);
+
+    // Relabels the grid if a closed cell may have split a region
+    void refresh();
+
+    // False only when no path from start to goal can exist. A start cell drawn
+    // on top of an obstacle is still left through its free neighbours.
+    // Read-only, so concurrent queries are safe. A stale index answers true.
+    bool connected(int start, int goal) const;
+
+    int componentCount();
+
+private:
+    int  find(int cell);
+    int  findNoCompress(int cell) const;
+    void unite(int a, int b);
+    void labelBand(int firstRow, int lastRow);
+
+    GridSnapshot snapshot;
+    std::vector<int> parent;    // -1 for obstacles
+    bool built;
+    bool stale;
+    int threads;
+    std::unique_ptr<WorkStealingExecutor> executor;
+};
+
+#endif // COMPONENTINDEX_H
@@ -0,0 +1,83 @@
+#ifndef CONTRACTIONHIERARCHY_H
+#define CONTRACTIONHIERARCHY_H
+
+#include <vector>
+#include "SearchEngine.h"
+
+// Contraction hierarchy over the free cells of a static grid. Nodes are
+// contracted in rounds: every round takes the nodes whose edge-difference
+// priority is lowest among their neighbours (an independent set), runs their
+// witness searches in parallel and then inserts the needed shortcuts.
+// Queries are bidirectional searches over upward arcs only.
+class ContractionHierarchy : public PreparedSolver
+{
+public:
+    // threads == 0 uses one thread per hardware thread for the build
+    explicit ContractionHierarchy(int threads = 0);
+
+    std::string name() const override;
+    void prepare(const GridSnapshot& snapshot) override;
+    bool isPrepared() const override;
+    void clear() override;
+
+    // The hierarchy is built for a static maze; any edit drops it
+    void setObstacle(int index, bool obstacle) override;
+
+    SearchResult query(int startIndex, int endIndex, SearchScratch& scratch) const override;
+    size_t memoryBytes() const override;
+    std::string statistics() const override;
+
+    int nodeCount() const;
+    long long shortcutCount() const;
+
+private:
+    struct Arc
+    {
+        int   target;
+        float cost;
+        int   middle;   // contracted node the shortcut bypasses, -1 for a grid edge
+    };
+
+    struct Shortcut
+    {
+        int   from;
+        int   to;
+        float cost;
+    };
+
+    // Per-thread Dijkstra state for witness searches
+    struct WitnessScratch
+    {
+        std::vector<float> dist;
+        std::vector<int> touched;
+        std::vector<std::pair<float, int>> heap;
+    };
+
+    // Shortcuts needed to contract node; skipRound also avoids the other nodes of the current round
+    void findShortcuts(int node, bool skipRound, int settleLimit, WitnessScratch& witness,
+                       std::vector<Shortcut>& out) const;
+    int  edgeDifference(int node, WitnessScratch& witness) const;
+    bool addOrImprove(int from, int to, float cost, int middle);
+    const Arc& findArc(int a, int b) const;
+    void unpack(int from, int to, std::vector<int>& pending, std::vector<int>& cells) const;
+
+    int threads;
+    bool prepared;
+    GridSnapshot snapshot;
+
+    std::vector<int> cellNode;      // cell -> node, -1 for obstacles
+    std::vector<int> nodeCell;
+    std::vector<int> rank;          // contraction order
+    long long shortcuts;
+
+    // Build-time graph of the not yet contracted nodes
+    std::vector<std::vector<Arc>> adjacency;
+    std::vector<uint8_t> inRound;
+    std::vector<int> contractedNeighbours;
+
+    // Upward arcs of every node (targets have higher rank), stored CSR
+    std::vector<int> upBegin;
+    std::vector<Arc> upArcs;
+};
+
+#endif // CONTRACTIONHIERARCHY_H
@@ -0,0 +1,38 @@
+#ifndef DATASETGENERATOR_H
+#define DATASETGENERATOR_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Command line options of the maze dataset mode
+struct DatasetOptions
+{
+    std::string outputFile;
+    std::vector<int> sizes = {32};
+    std::vector<float> densities = {0.25f};    // scattered obstacles, one group per density
+    bool mazes = false;                         // adds a group of carved mazes per size
+    int count = 1000;                           // grids per size and group
+    uint32_t seed = 1;
+    int threads = 0;                            // 0: one per hardware thread
+    int chunkSize = 256;
+};
+
+// Fills options from "--dataset <out.csv> [--sizes 32,64] [--densities 0.1,0.3]
+// [--mazes] [--count N] [--seed S] [--threads T] [--chunk K]".
+// Returns false when the program was not started in dataset mode.
+bool parseDatasetOptions(int argc, char* argv[], DatasetOptions& options);
+
+// Generates every grid on the work-stealing executor, solves it corner to
+// corner with every registry solver and writes one CSV row per grid: the
+// MazeFeatures fields (path length and expansions from Dijkstra), then the
+// expansions, path length, path cost and time of each solver, followed by its
+// SearchStats counters (zero in a PATHFINDING_NO_STATS build). Grid i uses
+// seed + i, so a row can be regenerated from its seed alone. Workers fill
+// private buffers that are appended to the file under a lock, so rows are
+// streamed in completion order and memory does not grow with the count.
+// Returns the process exit code.
+int runDataset(const DatasetOptions& options, std::ostream& out);
+
+#endif // DATASETGENERATOR_H
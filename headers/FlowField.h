@@ -0,0 +1,79 @@
+#ifndef FLOWFIELD_H
+#define FLOWFIELD_H
+
+#include <cstdint>
+#include <vector>
+#include "JobExecutor.h"
+#include "SearchEngine.h"
+
+// Next step towards the goal, in the neighbour order used by the solvers
+typedef enum : uint8_t {FLOW_EAST, FLOW_SOUTH, FLOW_WEST, FLOW_NORTH, FLOW_NONE} FLOWDIRECTIONS;
+
+// Distance from every cell to one goal plus the next-step direction of every
+// cell, so any number of agents can walk to the goal without searching.
+// The wavefront is computed tile by tile: each round, the tiles whose border
+// changed pull their neighbours' border values into a halo, then relax their
+// own cells in parallel. Rounds repeat until no border changes. The executor
+// and the workers' BFS queues are kept between compute() calls, so
+// recomputing after an edit starts no threads.
+class FlowField
+{
+public:
+    // threads == 0 uses one thread per hardware thread
+    explicit FlowField(int tileSize = 64, int threads = 0);
+
+    void compute(const GridSnapshot& snapshot, int goalIndex);
+    bool isComputed() const;
+    void clear();
+
+    int goal() const;
+    int width() const;
+
+    // Unreachable cells and obstacles hold INFINITY
+    float distanceAt(int cell) const;
+
+    // Obstacle cells (e.g. a start drawn on a wall) point to their nearest
+    // free neighbour. FLOW_NONE at the goal and for unreachable cells.
+    FLOWDIRECTIONS directionAt(int cell) const;
+
+    // Cell one step closer to the goal, -1 at the goal or when unreachable
+    int nextCell(int cell) const;
+
+    // Cells from cell to the goal, empty when unreachable. O(path length).
+    std::vector<int> pathFrom(int cell) const;
+
+    long long computeNs() const;
+    int rounds() const;
+    int reachableCells() const;
+    size_t memoryBytes() const;
+
+private:
+    struct Tile
+    {
+        int x0, y0, x1, y1;
+        std::vector<float> halo;    // east, south, west, north neighbours of the border cells
+        uint8_t changedSides;       // bit per side whose border cells improved
+    };
+
+    void pullHalo(Tile& tile) const;
+    void relaxTile(Tile& tile, std::vector<int>& queue);
+    void computeDirections(int firstRow, int lastRow);
+
+    int tileSize;
+    bool computed;
+    int goalIndex;
+    int roundCount;
+    int reachable;
+    long long lastComputeNs;
+
+    GridSnapshot snapshot;
+    std::vector<float> distance;
+    std::vector<uint8_t> direction;
+    std::vector<Tile> tiles;
+    int tilesX, tilesY;
+
+    WorkStealingExecutor executor;
+    std::vector<std::vector<int>> queues;  // one per executor worker
+};
+
+#endif // FLOWFIELD_H
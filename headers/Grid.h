@@ -0,0 +1,68 @@
+#ifndef GRID_H
+#define GRID_H
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Nodes are 1-based: xCoord runs 1..widthGrid, yCoord 1..heightGrid,
+// stored row-major from the bottom row (see coordToIndex)
+
+// Node structure
+struct Node
+{
+    // For all algorithms
+    int xCoord{}, yCoord{};
+    bool visited = false;
+    bool obstacle = false;
+    uint8_t cost = 1;   // terrain cost of entering the node
+
+    // used in BFS and DFS (true: in nextNodes) – kept for compatibility but not used
+    bool nextUp = false;
+
+    // used in ASTAR – kept for compatibility but not used
+    float globalGoal;
+    float localGoal;
+    Node* parent;
+    std::vector<Node*> neighbours;
+
+    // visited, nextUp, localGoal and parent belong to the search whose
+    // epoch this is; in any other search the node is still unreached
+    uint32_t searchStamp = 0;
+};
+
+// Grid structure
+struct grid
+{
+public:
+    std::vector<Node> Nodes;
+    int startIndex;
+    int endIndex;
+    int currentIndex;
+    uint32_t searchEpoch = 0;
+
+    // Starts a search or maze walk: every node becomes unreached in O(1),
+    // unless the epoch counter wraps around
+    void beginSearch()
+    {
+        if (++searchEpoch != 0) return;
+        for (Node& node : Nodes) node.searchStamp = 0;
+        searchEpoch = 1;
+    }
+
+    // Node for the current search, reset the first time it is reached
+    Node& touch(int index)
+    {
+        Node& node = Nodes[index];
+        if (node.searchStamp != searchEpoch) {
+            node.searchStamp = searchEpoch;
+            node.visited = false;
+            node.nextUp = false;
+            node.localGoal = INFINITY;
+            node.parent = nullptr;
+        }
+        return node;
+    }
+};
+
+#endif // GRID_H
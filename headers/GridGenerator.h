@@ -0,0 +1,19 @@
+#ifndef GRIDGENERATOR_H
+#define GRIDGENERATOR_H
+
+#include <cstdint>
+#include "SearchEngine.h"
+
+// Headless grid generators for batch work and benchmarks. Both keep the
+// snapshot's start and end cells free and produce the same grid for the
+// same seed on every platform and in every cell layout (snapshot.layout).
+
+// Each cell becomes an obstacle with probability density
+void scatterObstacles(GridSnapshot& snapshot, float density, uint32_t seed);
+
+// Recursive Backtracker as in MazeStepper: walls every cell, then carves
+// two-cell steps with an explicit stack. The walk starts at the start cell
+// and the goal is joined to the passages, so the two are always connected.
+void carveMaze(GridSnapshot& snapshot, uint32_t seed);
+
+#endif // GRIDGENERATOR_H
@@ -0,0 +1,30 @@
+#ifndef GRIDIO_H
+#define GRIDIO_H
+
+#include <string>
+#include "LandmarkPlanner.h"
+#include "SearchEngine.h"
+
+// Grid files use the MovingAI .map layout:
+//   type octile / height H / width W / map, then H rows of W characters.
+// '.', 'G' and 'S' are free cells, the digits '1' to '9' free cells with that
+// terrain cost, everything else is an obstacle. The cells are stored in the
+// layout snapshot has on entry; saving reads any layout.
+bool loadGridSnapshot(const std::string& path, GridSnapshot& snapshot, std::string* error = nullptr);
+
+bool saveGridSnapshot(const std::string& path, const GridSnapshot& snapshot, std::string* error = nullptr);
+
+// ALT tables live in a file of their own next to the map (landmarkPath), so
+// the map itself is never rewritten:
+//   landmarks K <obstacle checksum>, K lines "x row", then K floats per cell
+//   in host byte order. Tables are only written and read for row-major snapshots.
+std::string landmarkPath(const std::string& mapPath);
+bool saveLandmarkTable(const std::string& path, const GridSnapshot& snapshot, const LandmarkTable& table,
+                       std::string* error = nullptr);
+
+// Fails when there is no table or it was written for a different obstacle
+// layout than snapshot.
+bool loadLandmarkTable(const std::string& path, const GridSnapshot& snapshot, LandmarkTable& table,
+                       std::string* error = nullptr);
+
+#endif // GRIDIO_H
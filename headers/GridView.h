@@ -7,12 +7,17 @@
 #include <QLineSeries>
 #include <QGridLayout>
 #include <QObject>
+#include "Grid.h"
+#include "MazeFeatures.h"
+#include <cstdint>
 #include <vector>
 
 QT_USE_NAMESPACE
 
+class FlowField;
+
     // Possible interactions in the gridview chosen in the Interaction Box
-    typedef enum {START, END, OBST, NOINTERACTION} INTERACTIONS;
+    typedef enum {START, END, OBST, TERRAIN, NOINTERACTION} INTERACTIONS;
 
 // Possible grid arrangement chosen in the Maze Box
 typedef enum {EMPTY, MAZE, NOARRANG} ARRANGEMENTS;
@@ -24,49 +29,6 @@ typedef enum {DIJKSTRA, BACKTRACK, NOALGO} ALGOS;
 // Possible update in the grid view from the Path Algorithm
 typedef enum {CURRENT, FREE, VISIT, OBSTACLETOFREE, FREETOOBSTACLE, NEXT, PATH, LINE} UPDATETYPES;
 
-// Node structure
-struct Node
-{
-    // For all algorithms
-    int xCoord{}, yCoord{};
-    bool visited = false;
-    bool obstacle = false;
-
-    // used in BFS and DFS (true: in nextNodes) – kept for compatibility but not used
-    bool nextUp = false;
-
-    // used in ASTAR – kept for compatibility but not used
-    float globalGoal;
-    float localGoal;
-    Node* parent;
-    std::vector<Node*> neighbours;
-};
-
-// Grid structure
-struct grid
-{
-public:
-    std::vector<Node> Nodes;
-    int startIndex;
-    int endIndex;
-    int currentIndex;
-};
-
-// Struct to hold maze features for difficulty estimation
-struct MazeFeatures {
-    int gridWidth;
-    int gridHeight;
-    float wallDensity;
-    int shortestPathLength;
-    int nodesVisited;
-    int numDeadEnds;
-    float branchingFactor;
-
-    MazeFeatures() : gridWidth(0), gridHeight(0), wallDensity(0.0f),
-        shortestPathLength(0), nodesVisited(0),
-        numDeadEnds(0), branchingFactor(0.0f) {}
-};
-
 // Converting point coordinates to index
 int coordToIndex(const QPointF& point, int widthGrid);
 int coordToIndex(int x, int y, int widthGrid);
@@ -135,15 +97,32 @@ public:
     // Modifying View
     void setElementsMarkerSize();
 
+    // Terrain levels painted by the TERRAIN interaction, cycled on each click
+    static const std::vector<uint8_t>& terrainLevels();
+
+    // Redraws the terrain overlay from the node costs
+    void updateTerrainView();
+
+    // Flow field overlay: one arrow per reachable cell pointing to its next step
+    void showFlowField(const FlowField& field);
+    void clearFlowField();
+
     //Function to get the path length from the pathLine series
     int getPathLength() const;
 
     // Add this new function declaration:
     void setupNodes();
-    // Feature extraction methods
-    float calculateWallDensity() const;
-    int countDeadEnds() const;
-    float calculateBranchingFactor() const;
+
+Q_SIGNALS:
+
+    // Emitted by handleClickedPoint for every cell whose obstacle flag was set
+    void cellObstacleChanged(int index, bool obstacle);
+
+    // Emitted by handleClickedPoint when a TERRAIN click changed a cell's cost
+    void cellCostChanged(int index, int cost);
+
+    // Emitted by handleClickedPoint when the start (START) or goal (END) moved
+    void endpointMoved(INTERACTIONS endpoint, int index);
 
 public Q_SLOTS:
 
@@ -168,6 +147,12 @@ public:
 
     QLineSeries* pathLine;
 
+    // Terrain overlay, one series per terrain level above 1
+    std::vector<QScatterSeries*> terrainElements;
+
+    // Flow field arrows, one series per FLOWDIRECTIONS value
+    std::vector<QScatterSeries*> flowElements;
+
     int widthGrid;
     int heightGrid;
     qreal markerSize;
@@ -180,6 +165,10 @@ public:
 
     grid gridNodes;
 
+protected:
+    // Traced, so chart repaints show up as frames in an exported timeline
+    void paintEvent(QPaintEvent* event) override;
+
 };
 
 #endif // GRIDVIEW_H
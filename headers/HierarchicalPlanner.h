@@ -0,0 +1,109 @@
+#ifndef HIERARCHICALPLANNER_H
+#define HIERARCHICALPLANNER_H
+
+#include <unordered_map>
+#include <vector>
+#include "SearchEngine.h"
+
+// Cluster layout of the hierarchy. Level 1 clusters are clusterSize cells
+// wide, each higher level groups levelFactor x levelFactor clusters of the
+// level below. levels == 0 adds levels until the top has at most 1024 clusters.
+struct HierarchyConfig
+{
+    int clusterSize = 16;
+    int levels = 0;
+    int levelFactor = 4;
+};
+
+// Hierarchical pathfinding (HPA*). Entrances between neighbouring clusters
+// become abstract nodes, linked by exact in-cluster distances. A query
+// connects start and goal to their cluster's nodes, searches the abstract
+// graph (using the coarsest level that contains neither endpoint) and
+// refines each abstract edge back into cells. Paths are near-optimal:
+// border crossings are restricted to the entrance transitions.
+class HierarchicalPlanner : public PreparedSolver
+{
+public:
+    explicit HierarchicalPlanner(const HierarchyConfig& config = HierarchyConfig());
+
+    std::string name() const override;
+    void prepare(const GridSnapshot& snapshot) override;
+    bool isPrepared() const override;
+    void clear() override;
+
+    // Re-abstracts only the level 1 cluster holding the cell, its four
+    // neighbours (which share its borders) and the higher level clusters above them
+    void setObstacle(int index, bool obstacle) override;
+
+    SearchResult query(int startIndex, int endIndex, SearchScratch& scratch) const override;
+    size_t memoryBytes() const override;
+    std::string statistics() const override;
+
+    int levelCount() const;
+    int nodeCount() const;
+
+private:
+    // Edge kinds used when refining: inter-cluster step, or a BFS in a level 1 cluster
+    enum { INTER_EDGE = 0, LOCAL_EDGE = -1 };
+
+    struct Edge
+    {
+        int   target;
+        float cost;
+        int   border;   // owning border for inter edges, -1 for intra edges
+    };
+
+    struct AbstractNode
+    {
+        int cell;
+        int level;      // highest level whose cluster border the node lies on
+        int refs;       // number of borders using this node, 0 once freed
+        std::vector<Edge> inter;
+    };
+
+    struct Rect
+    {
+        int x0, y0, x1, y1;     // half-open
+    };
+
+    int  clusterSizeAt(int level) const;
+    int  clustersXAt(int level) const;
+    int  clustersYAt(int level) const;
+    int  clusterOf(int cell, int level) const;
+    Rect clusterRect(int cluster, int level) const;
+    int  crossingLevel(int cellA, int cellB) const;
+
+    int  acquireNode(int cell, int border);
+    void releaseBorder(int border);
+    void buildBorder(int cluster, int side);
+    void updateNodeLevel(int node);
+    void buildIntraLevel1(int cluster);
+    void buildIntraLevel(int level, int cluster);
+    void nodesInCluster(int level, int cluster, int minLevel, std::vector<int>& out) const;
+
+    // BFS on the grid restricted to rect; dist/parent are rect-local
+    void rectBfs(const Rect& rect, int source, std::vector<int>& dist, std::vector<int>& parent,
+                 std::vector<int>& queue) const;
+    void appendRectPath(const Rect& rect, int from, int to, SearchScratch& scratch, std::vector<int>& cells) const;
+
+    // Dijkstra on the abstract graph restricted to one cluster, using edges one level down
+    void clusterDijkstra(int level, int cluster, int source, std::unordered_map<int, float>& dist,
+                         std::unordered_map<int, std::pair<int, int>>* parent) const;
+    void appendRefinedEdge(int fromNode, int toNode, int kind, SearchScratch& scratch, std::vector<int>& cells) const;
+
+    int usageLevel(int node, int startCell, int goalCell) const;
+
+    HierarchyConfig config;
+    GridSnapshot snapshot;
+    bool prepared;
+    int levels;
+
+    std::vector<AbstractNode> nodes;
+    std::vector<int> freeNodes;
+    std::unordered_map<int, int> cellNode;
+    std::vector<std::vector<int>> clusterNodes;         // level 1 cluster -> live nodes
+    std::vector<std::vector<int>> borderNodes;          // cluster * 2 + side -> nodes
+    std::vector<std::vector<std::vector<Edge>>> intra;  // [level - 1][node]
+};
+
+#endif // HIERARCHICALPLANNER_H
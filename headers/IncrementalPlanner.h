@@ -0,0 +1,63 @@
+#ifndef INCREMENTALPLANNER_H
+#define INCREMENTALPLANNER_H
+
+#include <utility>
+#include <vector>
+#include "SearchEngine.h"
+
+// Lifelong Planning A* (LPA*) on the 4-connected snapshot, each step costing
+// the terrain cost of the cell it enters, as Dijkstra weighs it.
+// g/rhs values survive between queries, so after an obstacle flip or a goal
+// move only the cells made inconsistent by the edit are expanded again.
+// Moving the start invalidates everything and triggers a full search.
+class IncrementalPlanner
+{
+public:
+    IncrementalPlanner();
+
+    // Full initialisation on a new grid; start and goal come from the snapshot
+    void reset(const GridSnapshot& snapshot);
+    bool isInitialised() const;
+    void clear();
+
+    // Edits, applied lazily by the next computePath()
+    void setObstacle(int index, bool obstacle);
+    void setCost(int index, int cost);
+    void setGoal(int index);
+    void setStart(int index);
+
+    // Repairs the inconsistent cells and returns the current shortest path.
+    // nodesVisited counts only the expansions done by this call.
+    SearchResult computePath();
+
+    const GridSnapshot& getSnapshot() const;
+
+private:
+    typedef std::pair<float, float> Key;
+
+    Key   calculateKey(int cell) const;
+    float heuristic(int cell) const;
+    int   neighbours(int cell, int* out) const;
+    void  updateVertex(int cell);
+    void  rebuildQueueKeys();
+
+    // Indexed binary min-heap, heapPos[cell] == -1 when the cell is not queued
+    void heapPush(int cell, const Key& key);
+    void heapRemove(int cell);
+    void heapUpdate(int cell, const Key& key);
+    int  heapPop();
+    void siftUp(int pos);
+    void siftDown(int pos);
+    void heapSwap(int a, int b);
+
+    GridSnapshot snapshot;
+    bool initialised;
+    bool needsFullReset;
+
+    std::vector<float> g;
+    std::vector<float> rhs;
+    std::vector<int> heapPos;
+    std::vector<std::pair<Key, int>> heap;
+};
+
+#endif // INCREMENTALPLANNER_H
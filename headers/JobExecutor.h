@@ -0,0 +1,87 @@
+#ifndef JOBEXECUTOR_H
+#define JOBEXECUTOR_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Per-thread counters collected during a batch
+struct WorkerReport
+{
+    long long jobsDone = 0;
+    long long chunksStolen = 0;
+    long long busyNs = 0;
+};
+
+// Summary of one batch: wall time, throughput and per-thread utilisation
+struct BatchReport
+{
+    long long jobCount = 0;
+    long long wallNs = 0;
+    std::vector<WorkerReport> workers;
+
+    double queriesPerSecond() const;
+    double utilisation(int worker) const;
+};
+
+// Work-stealing executor for large sets of independent jobs.
+// Jobs are submitted in chunks spread over per-thread deques. A thread pops
+// chunks from the back of its own deque and, once empty, steals from the
+// front of another thread's deque, so a few expensive queries do not leave
+// the other threads idle.
+// The worker threads are started by the first run() and wait for the next
+// one until the executor is destroyed, so an executor kept across many
+// small runs does not create threads for each. A run with a single chunk
+// stays on the calling thread.
+class WorkStealingExecutor
+{
+public:
+    explicit WorkStealingExecutor(int threadCount = 0, int chunkSize = 64);
+    ~WorkStealingExecutor();
+    WorkStealingExecutor(const WorkStealingExecutor&) = delete;
+    WorkStealingExecutor& operator=(const WorkStealingExecutor&) = delete;
+
+    int threadCount() const;
+
+    // Runs task(jobIndex, workerIndex) once for every index in [0, jobCount).
+    // One run at a time; the calling thread is worker 0.
+    BatchReport run(size_t jobCount, const std::function<void(size_t, int)>& task);
+
+private:
+    struct Chunk
+    {
+        size_t begin;
+        size_t end;
+    };
+
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<Chunk> chunks;
+    };
+
+    bool popLocal(int worker, Chunk& chunk);
+    bool steal(int thief, Chunk& chunk);
+    void poolLoop(int worker);
+
+    int threads;
+    int chunkSize;
+    std::vector<WorkerQueue> queues;
+
+    // Parked worker threads 1 to threads - 1, woken by a new generation
+    std::vector<std::thread> pool;
+    std::mutex poolMutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    const std::function<void(int)>* workerLoop = nullptr;
+    unsigned long long generation = 0;
+    int activeWorkers = 0;              // workers taking part in the current run
+    int runningWorkers = 0;             // pool threads still busy with it
+    bool stopping = false;
+};
+
+#endif // JOBEXECUTOR_H
@@ -0,0 +1,67 @@
+#ifndef LANDMARKPLANNER_H
+#define LANDMARKPLANNER_H
+
+#include <vector>
+#include "SearchEngine.h"
+
+// Exact distances from each landmark to every cell. Rows are cell-major and
+// padded to a multiple of 8 floats so a whole row fits SIMD registers;
+// cells a landmark cannot reach hold -1.
+struct LandmarkTable
+{
+    int count = 0;
+    int stride = 0;
+    std::vector<int> cells;         // landmark cell indices
+    std::vector<float> distance;    // cellCount * stride
+
+    static int strideFor(int count) { return (count + 7) / 8 * 8; }
+    const float* row(int cell) const { return distance.data() + static_cast<size_t>(cell) * stride; }
+};
+
+// FNV-1a hash of the obstacle plane, stored with the table to detect edited maps
+unsigned long long obstacleChecksum(const GridSnapshot& snapshot);
+
+// A* with ALT (A*, Landmarks, Triangle inequality) lower bounds:
+// h(v) = max over landmarks l of |d(l, v) - d(l, goal)|.
+class LandmarkPlanner : public PreparedSolver
+{
+public:
+    // threads == 0 uses one thread per hardware thread for the table build
+    explicit LandmarkPlanner(int landmarkCount = 8, int threads = 0);
+
+    std::string name() const override;
+
+    // Picks the landmarks by farthest-point selection, then runs one full-grid
+    // search per landmark in parallel
+    void prepare(const GridSnapshot& snapshot) override;
+
+    // Uses tables loaded from a grid file instead of building them. Returns
+    // false (and leaves the planner unprepared) when they do not match the grid.
+    bool adopt(const GridSnapshot& snapshot, const LandmarkTable& table);
+
+    bool isPrepared() const override;
+    void clear() override;
+
+    // Closing a cell only lengthens paths, so the bounds stay admissible and
+    // the tables are kept. Opening one drops them.
+    void setObstacle(int index, bool obstacle) override;
+
+    SearchResult query(int startIndex, int endIndex, SearchScratch& scratch) const override;
+    size_t memoryBytes() const override;
+    std::string statistics() const override;
+
+    const LandmarkTable& landmarks() const;
+
+private:
+    float lowerBound(int cell, const float* goalRow) const;
+    void  selectLandmarks(std::vector<int>& cells) const;
+    void  distancesFrom(int source, std::vector<int>& dist, std::vector<int>& queue) const;
+
+    int landmarkCount;
+    int threads;
+    bool prepared;
+    GridSnapshot snapshot;
+    LandmarkTable table;
+};
+
+#endif // LANDMARKPLANNER_H
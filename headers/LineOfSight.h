@@ -0,0 +1,47 @@
+#ifndef LINEOFSIGHT_H
+#define LINEOFSIGHT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct GridSnapshot;
+
+// Visibility between cell centres on the obstacle plane. A segment is clear
+// when every cell it passes through is free; where it crosses a cell corner
+// exactly, both cells beside the corner must be free, matching the no
+// corner cutting rule of 8-connected moves. Integer arithmetic only.
+// Answers are cached per unordered cell pair in a bounded direct-mapped
+// table; begin() starts a new query and retires the old entries in O(1).
+class LineOfSight
+{
+public:
+    explicit LineOfSight(int cacheSlots = 1 << 16);
+
+    void begin(const GridSnapshot& snapshot);
+    bool visible(int a, int b);
+
+    long long calls() const { return callCount; }
+    long long cacheHits() const { return hitCount; }
+    size_t memoryBytes() const;
+
+private:
+    bool trace(int a, int b) const;
+
+    struct Slot
+    {
+        uint64_t key;
+        uint32_t stamp;
+        uint8_t visible;
+    };
+
+    const GridSnapshot* snapshot = nullptr;
+    std::vector<Slot> slots;
+    size_t slotCount;
+    size_t mask;
+    uint32_t stamp = 0;
+    long long callCount = 0;
+    long long hitCount = 0;
+};
+
+#endif // LINEOFSIGHT_H
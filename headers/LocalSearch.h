@@ -0,0 +1,30 @@
+#ifndef LOCALSEARCH_H
+#define LOCALSEARCH_H
+
+#include "SearchEngine.h"
+
+// A* on the 4-connected grid for short hops on large maps, weighing steps
+// by the terrain costs like Dijkstra. Nothing per grid is built: neighbours
+// are read from the snapshot, and the state of the reached cells starts in
+// scratch.sparse, a hash table whose size follows the cells reached instead
+// of the grid. Once more than denseThreshold cells are reached the state
+// moves to the stamped dense arrays (SearchScratch::beginQuery) and the
+// search continues there, so long queries run at the dense solvers' speed.
+// Cells are addressed through the snapshot's layout, so tiled grids are
+// searched in place. Ties are broken by cell index, so the two layouts of
+// one grid can give different paths of the same cost.
+struct LocalSearchOptions
+{
+    int radius = 0;             // Manhattan distance from the start a path may go, 0: unbounded.
+                                // A goal beyond it fails without expanding anything.
+    int denseThreshold = 0;     // 0: a sixteenth of the grid, at least 4096 cells
+};
+
+// Same expansions and path as A* while the radius does not cut the search
+SearchResult localSearch(const GridSnapshot& snapshot, int startIndex, int endIndex, SearchScratch& scratch,
+                         const LocalSearchOptions& options);
+
+// Registry entry: unbounded radius, automatic threshold
+SearchResult localAStarSearch(const GridSnapshot& snapshot, int startIndex, int endIndex, SearchScratch& scratch);
+
+#endif // LOCALSEARCH_H
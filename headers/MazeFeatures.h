@@ -0,0 +1,67 @@
+#ifndef MAZEFEATURES_H
+#define MAZEFEATURES_H
+
+#include <cstdint>
+#include <vector>
+#include "SearchEngine.h"
+
+// Struct to hold maze features for difficulty estimation
+struct MazeFeatures {
+    int gridWidth;
+    int gridHeight;
+    float wallDensity;
+    int shortestPathLength;
+    int nodesVisited;
+    int numDeadEnds;
+    float branchingFactor;
+
+    MazeFeatures() : gridWidth(0), gridHeight(0), wallDensity(0.0f),
+        shortestPathLength(0), nodesVisited(0),
+        numDeadEnds(0), branchingFactor(0.0f) {}
+};
+
+// Grid statistics behind MazeFeatures, counted in one pass over a bitboard
+// of the free cells (rows packed into 64-bit words, zero words around the
+// grid). Neighbour planes are the free plane shifted by one bit or one row,
+// so dead ends and adjacent free pairs are popcounts of a few ands and xors.
+// Edits update the counts around the changed cell in O(1).
+// Cells outside the grid count as walls, as in the original per-cell loops.
+// The bitboard is always row by row; cell indexes follow the snapshot's layout.
+class MazeFeatureIndex
+{
+public:
+    void build(const GridSnapshot& snapshot);
+    bool isBuilt() const { return built; }
+    void clear();
+
+    // Keeps the counts in sync with a single cell edit, index in the layout
+    // of the snapshot the index was built from
+    void setObstacle(int index, bool obstacle);
+
+    float wallDensity() const;
+    int deadEnds() const { return deadEndCount; }
+    float branchingFactor() const;     // mean number of free neighbours of a free cell
+
+    // Grid fields of MazeFeatures; the search fields are the caller's
+    MazeFeatures features(int shortestPathLength = 0, int nodesVisited = 0) const;
+
+private:
+    bool isFree(int x, int y) const;
+    int freeNeighbours(int x, int y) const;
+
+    // Contribution of the cell and its four neighbours to the counts
+    void countAround(int x, int y, int sign);
+
+    bool built = false;
+    int width = 0;
+    int height = 0;
+    int stride = 0;                 // words per row, guard words included
+    CELLLAYOUTS layout = LAYOUT_ROW_MAJOR;
+    std::vector<uint64_t> freePlane;
+
+    long long freeCount = 0;
+    long long deadEndCount = 0;
+    long long adjacentPairs = 0;    // free cells sharing a side, each pair once
+};
+
+#endif // MAZEFEATURES_H
@@ -0,0 +1,135 @@
+#ifndef MULTIAGENTPLANNER_H
+#define MULTIAGENTPLANNER_H
+
+#include <cstdint>
+#include <vector>
+#include "SearchEngine.h"
+
+// Space-time reservations keyed by (cell, t). Open addressing over packed
+// 64-bit slots: the low 44 bits hold t * cellCount + cell, the high 20 bits
+// the owning agent + 1 (0 marks an empty slot). Lookups are read-only and
+// safe from several threads while nobody reserves.
+class ReservationTable
+{
+public:
+    ReservationTable();
+
+    void reset(int cellCount);
+    void reserve(int cell, int t, int agent);
+
+    // Agent holding (cell, t), -1 when free
+    int owner(int cell, int t) const;
+
+    size_t size() const;
+    size_t memoryBytes() const;
+
+    static const int kMaxAgents = (1 << 20) - 1;
+
+private:
+    void grow();
+
+    std::vector<uint64_t> slots;
+    uint64_t cells;
+    size_t count;
+    int shift;
+};
+
+struct MultiAgentConfig
+{
+    int threads = 0;            // 0: one per hardware thread
+    int batchSize = 0;          // agents planned speculatively together, 0: 8 per thread
+    int maxExpansions = 1 << 16;    // per agent search
+    int horizon = 0;            // latest arrival time, 0: 4 * (width + height)
+    float heuristicWeight = 1.2f;   // above 1: fewer expansions for slightly longer paths
+};
+
+// Collision-free paths for many agents on one grid
+struct MultiAgentResult
+{
+    std::vector<std::vector<int>> paths;    // paths[a][t]: cell of agent a at time t, empty if unplanned
+    int planned = 0;
+    int failed = 0;
+    int makespan = 0;
+    long long sumOfCosts = 0;
+    long long expansions = 0;
+    int replans = 0;            // speculative plans dropped for a conflict inside their batch
+    long long timeElapsedNs = 0;
+    size_t memoryBytes = 0;
+};
+
+// Cooperative A*: agents are planned one after another in priority order
+// (their order in the input) with space-time A* that avoids every cell and
+// edge reserved by the agents before them. Arrived agents stay on their goal.
+// The heuristic is the Manhattan distance; agents that need too many
+// expansions with it are searched again with grid distances from a
+// breadth-first search confined to a band between start and goal.
+// Batches of agents are planned in parallel against the table as it was at
+// the start of the batch, then committed in priority order; a plan that now
+// collides with an agent committed earlier in the same batch is replanned.
+class MultiAgentPlanner
+{
+public:
+    struct Agent
+    {
+        int startIndex;
+        int goalIndex;
+    };
+
+    explicit MultiAgentPlanner(const MultiAgentConfig& config = MultiAgentConfig());
+
+    // Agents on obstacles or sharing a start or goal with an earlier agent
+    // are not planned and count as failed
+    MultiAgentResult plan(const GridSnapshot& snapshot, const std::vector<Agent>& agents);
+
+    size_t reservationCount() const;
+
+private:
+    // Per-thread space-time A* state
+    struct Scratch
+    {
+        struct Node { int cell; int t; int parent; };
+        struct Entry { int f; int g; int h; int node; };
+
+        std::vector<Node> nodes;
+        std::vector<Entry> heap;
+        std::vector<uint64_t> seen;     // open addressing set of (cell, t) keys
+        std::vector<uint32_t> seenStamp;
+        uint32_t stamp = 0;
+        size_t seenCount = 0;
+
+        // Distances from the goal on the walled grid, -1 outside the searched band
+        std::vector<int> goalDistance;
+        std::vector<int> queue;         // labelled cells, reset by the next search
+
+        void beginSearch();
+        void clearGoalDistances(int cellCount);
+        bool insert(uint64_t key);
+    };
+
+    bool canMove(int agent, int from, int to, int t) const;
+    bool canStay(int agent, int goal, int arrival) const;
+    int  padded(int cell) const;
+    void labelGoalDistances(const Agent& spec, Scratch& scratch) const;
+    int  distanceToGoal(int cell, const Agent& spec, const Scratch& scratch) const;
+    bool planAgent(int agent, const Agent& spec, Scratch& scratch, std::vector<int>& path,
+                   long long& expansions) const;
+    bool searchAgent(int agent, const Agent& spec, int budget, Scratch& scratch, std::vector<int>& path,
+                     long long& expansions) const;
+    bool stillValid(int agent, const std::vector<int>& path) const;
+    void commit(int agent, const std::vector<int>& path);
+
+    MultiAgentConfig config;
+    GridSnapshot snapshot;
+    int horizon;
+    std::vector<uint8_t> walled;    // obstacles with a one cell border of walls
+
+    ReservationTable reservations;
+    std::vector<int> lastReserved;  // latest t any agent occupies the cell, -1 if never
+    std::vector<int> parkedFrom;    // time an agent arrives and stays on the cell
+};
+
+// Vertex and swap conflicts between the paths, with arrived agents kept on
+// their goal until the last one arrives. 0 for a valid plan.
+long long countConflicts(const std::vector<std::vector<int>>& paths);
+
+#endif // MULTIAGENTPLANNER_H
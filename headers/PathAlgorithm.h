@@ -5,9 +5,13 @@
 
 #include <QtConcurrent>
 #include <QFuture>
+#include <QTimer>
 #include "GridView.h"
+#include "SearchEngine.h"
 #include <queue> // for std::priority_queue
 #include <cmath> // For fabsf
+#include <memory>
+#include <stack>
 
 // For Dijkstra: orders by localGoal (min-heap)
 struct CompareNodesDijkstra {
@@ -16,6 +20,93 @@ struct CompareNodesDijkstra {
     }
 };
 
+// Read-only flat copy of the grid for headless solvers
+GridSnapshot snapshotFromGrid(const grid& gridNodes, int widthGrid, int heightGrid);
+
+// Fills node.neighbours with the 4-connected neighbours inside the grid
+void fillNodeNeighbours(grid& gridNodes, Node& node, int widthGrid, int heightGrid);
+
+// One change in the grid view produced by a solver step.
+// LINE updates add the cell to the path line, clearing it first if clearPrior is set.
+struct StepUpdate
+{
+    UPDATETYPES type;
+    int index;
+    bool clearPrior = false;
+};
+
+// Resumable Dijkstra. Each unit of step() expands one node, or draws one
+// path cell once the search is over. Owns its copy of the grid, so any
+// number of steppers can be advanced from the same thread.
+class DijkstraStepper
+{
+public:
+    DijkstraStepper(const grid& gridNodes, int widthGrid, int heightGrid);
+    DijkstraStepper(const DijkstraStepper&) = delete;
+    DijkstraStepper& operator=(const DijkstraStepper&) = delete;
+
+    // Advances by up to n units, appending view changes. Returns false once finished.
+    bool step(int n, std::vector<StepUpdate>& updates);
+
+    bool searchFinished() const;
+    bool finished() const;
+    int nodesVisited() const;
+    int pathLength() const;
+    const SearchStats& stats() const { return searchStats; }
+    // Time spent inside step() and the constructor, without the animation
+    const SearchTiming& timing() const { return timer.timing(); }
+
+private:
+    enum Phase {SEARCHING, TRACING, DONE};
+
+    void expandNext(std::vector<StepUpdate>& updates);
+    void finishSearch();
+    void drawNextPathCell(std::vector<StepUpdate>& updates);
+
+    grid gridNodes;
+    int widthGrid;
+    int heightGrid;
+    Phase phase;
+
+    TerrainCosts terrain;
+    std::priority_queue<Node*, std::vector<Node*>, CompareNodesDijkstra> open;
+    int visitedCount;
+    SearchStats searchStats;
+    PhaseTimer timer;
+    std::vector<int> path;
+    size_t pathCursor;
+};
+
+// Resumable Recursive Backtracker. The first step walls the whole grid, then
+// each unit of step() carves one passage or backtracks one cell.
+class MazeStepper
+{
+public:
+    MazeStepper(const grid& gridNodes, int widthGrid, int heightGrid);
+    MazeStepper(const MazeStepper&) = delete;
+    MazeStepper& operator=(const MazeStepper&) = delete;
+
+    // Advances by up to n units, appending view changes. Returns false once finished.
+    bool step(int n, std::vector<StepUpdate>& updates);
+
+    bool finished() const;
+    const grid& getGrid() const;
+
+private:
+    enum Phase {WALLS, CARVE, DONE};
+
+    void buildWalls(std::vector<StepUpdate>& updates);
+    void carveNext(std::vector<StepUpdate>& updates);
+
+    grid gridNodes;
+    int widthGrid;
+    int heightGrid;
+    Phase phase;
+
+    std::stack<Node*> stack;
+    int visitedCount;
+};
+
 class PathAlgorithm : public QObject
 {
     Q_OBJECT
@@ -29,17 +120,13 @@ public:
     void setSpeedVizualization(int speed);
     void setSimulationOnGoing(bool onGoing);
 
+    void setStepsPerTick(int steps);
+
     void runAlgorithm(ALGOS algorithm);
     void pauseAlgorithm();
     void resumeAlgorithm();
     void stopAlgorithm();
 
-    // Path planning – Dijkstra only
-    void performDijkstraAlgorithm(QPromise<int>& promise);
-
-    // Maze generation – Recursive Backtracker only
-    void performRecursiveBackTrackerAlgorithm(QPromise<int>& promise);
-
     std::vector<Node> retrieveNeighborsGrid(const grid& gridNodes, const Node& currentNode, int widthGrid, int heightGrid);
     void FillNeighboursNode(Node& node);
     void checkGridNode(grid gridNodes, int heightGrid, int widthGrid);
@@ -50,24 +137,40 @@ signals:
     void algorithmCompleted();
     void pathfindingSearchCompleted(int nodesVisited, int pathLength);
 
+private slots:
+    // Advances the running stepper by stepsPerTick units
+    void advanceSimulation();
+
 private:
     // Helper for Recursive Backtracker
     std::vector<Node*> getMazeNeighbors(Node* node);
     void connectNodes(Node* a, Node* b);
 
+    void emitStepUpdates();
+
 public:
     ALGOS currentAlgorithm;
     bool running;
     bool simulationOnGoing;
     bool endReached;
     int speedVisualization;
+    int stepsPerTick;
 
     grid gridNodes;
     int heightGrid;
     int widthGrid;
 
     QThreadPool pool;
-    QFuture<int> futureOutput;
+
+    // Visualised runs are stepped from this timer on the GUI thread
+    QTimer stepTimer;
+    std::unique_ptr<DijkstraStepper> dijkstraStepper;
+    std::unique_ptr<MazeStepper> mazeStepper;
+    std::vector<StepUpdate> stepUpdates;
+
+    // Counters and timing of the last visualised search, set before pathfindingSearchCompleted
+    SearchStats lastSearchStats;
+    SearchTiming lastSearchTiming;
 
     QString algorithmToString(ALGOS algo);
     void setGridNodes(const grid& newGridNodes, int width, int height);
@@ -0,0 +1,43 @@
+#ifndef RACEVIEW_H
+#define RACEVIEW_H
+
+#include <QWidget>
+#include <QSplitter>
+#include <QLabel>
+#include <QtCharts/QChartView>
+#include <QtCharts/QScatterSeries>
+#include <QLineSeries>
+#include "SearchEngine.h"
+
+QT_USE_NAMESPACE
+
+// Split view with one panel per run of a race, all drawn on the same grid snapshot
+class RaceView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit RaceView(QWidget* parent = nullptr);
+
+    // Drop previous panels and create one panel per run
+    void startRace(const GridSnapshot& snapshot, const QStringList& runNames);
+
+    // Draw a finished run in its panel
+    void showResult(int runIndex, const SearchResult& result);
+
+private:
+    struct Panel
+    {
+        QLabel*      label;
+        QLineSeries* pathLine;
+        QString      name;
+    };
+
+    QChartView* createPanelChart(QLineSeries* pathLine);
+
+    QSplitter*   splitter;
+    QList<Panel> panels;
+    GridSnapshot snapshot;
+};
+
+#endif // RACEVIEW_H
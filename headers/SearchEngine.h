@@ -0,0 +1,242 @@
+#ifndef SEARCHENGINE_H
+#define SEARCHENGINE_H
+
+#include <cstddef>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "CellLayout.h"
+#include "LineOfSight.h"
+#include "SearchTiming.h"
+#include "SparseCellMap.h"
+#include "TerrainCost.h"
+
+// Fresh value for GridSnapshot::revision, unique across threads
+uint64_t nextSnapshotRevision();
+
+// Read-only flat copy of the grid used by headless (non-animated) searches.
+// Cells are stored row-major with the same index as coordToIndex by default,
+// or in 64x64 tiles (CellLayout.h); cellAt() and cellCoords() map 0-based
+// coordinates for either layout.
+struct GridSnapshot
+{
+    int width = 0;
+    int height = 0;
+    int startIndex = 0;
+    int endIndex = 0;
+    CELLLAYOUTS layout = LAYOUT_ROW_MAJOR;
+    std::vector<uint8_t> obstacle;
+
+    // Cost of entering each cell, 1 to kMaxTerrainCost. Empty when every
+    // cell costs 1. Dijkstra and the LPA* replanner weigh steps by it; the
+    // prepared solvers, the flow field and the multi-agent planner count steps.
+    std::vector<uint8_t> cost;
+
+    static constexpr int kMaxTerrainCost = 9;
+
+    // Identifies the cell contents, so planes built from them (TerrainCosts)
+    // are reused until it changes. Copies share it; code that changes
+    // obstacle or cost in place calls markEdited().
+    uint64_t revision = nextSnapshotRevision();
+
+    int cellCount() const { return width * height; }
+    float costAt(int cell) const { return cost.empty() ? 1.0f : cost[cell]; }
+    void markEdited() { revision = nextSnapshotRevision(); }
+
+    int cellAt(int x, int y) const
+    {
+        return layout == LAYOUT_TILED ? TiledLayout{width, height}.index(x, y) : y * width + x;
+    }
+    void cellCoords(int cell, int& x, int& y) const
+    {
+        if (layout == LAYOUT_TILED)
+            TiledLayout{width, height}.coords(cell, x, y);
+        else
+            RowMajorLayout{width, height}.coords(cell, x, y);
+    }
+};
+
+// Copy of snapshot with its cells, start and end stored in layout
+GridSnapshot withLayout(const GridSnapshot& snapshot, CELLLAYOUTS layout);
+
+// Hot-path counters of one search, kept by the searching thread in its own
+// result so concurrent runs never share them. Build with CONFIG+=nostats
+// (defines PATHFINDING_NO_STATS) to compile the counting out; every field
+// then stays 0.
+struct SearchStats
+{
+    long long pushes = 0;
+    long long pops = 0;
+    long long stalePops = 0;        // popped again after the cell was closed
+    long long relaxations = 0;      // neighbour edges examined
+    long long decreaseKeys = 0;     // improvements of a cell already queued, pushed again
+    size_t peakOpen = 0;            // largest open set (the frontier layer for BFS)
+    size_t peakMemoryBytes = 0;
+
+    // Sums the counters and keeps the larger peaks
+    void add(const SearchStats& other);
+};
+
+#ifdef PATHFINDING_NO_STATS
+#define SEARCH_STAT(statement) do {} while (0)
+#else
+#define SEARCH_STAT(statement) do { statement; } while (0)
+#endif
+
+// Outcome of a single headless search
+struct SearchResult
+{
+    int nodesVisited = 0;
+    int pathLength = 0;             // number of steps, 0 when no path was found
+    float pathCost = 0.0f;          // any-angle solvers: Euclidean length
+    long long lineOfSightChecks = 0;    // any-angle solvers only
+    long long timeElapsedNs = 0;    // solver time only, timing.totalNs() where phases are measured
+    size_t memoryBytes = 0;
+    SearchStats stats;
+    SearchTiming timing;            // phases and hardware counters, all 0 when not measured
+    std::vector<int> path;          // cell indices from start to goal, waypoints for any-angle solvers
+};
+
+// Scratch buffers owned by a single run. Concurrent runs each use their own.
+// Buffers are only cleared between queries, never shrunk, so once a scratch
+// has served one query on a grid the next ones reuse its memory.
+// Solvers that start with beginQuery() instead of prepare() do not clear
+// distance, parent and closed at all: a cell's entries count only while its
+// stamp equals the query's epoch, and touch() resets them on first access.
+struct SearchScratch
+{
+    std::vector<float> distance;
+    std::vector<int> parent;
+    std::vector<uint8_t> closed;
+    std::vector<uint32_t> stamp;    // epoch of the query that last touched each cell
+    uint32_t epoch = 0;
+    std::vector<std::pair<float, int>> open;
+    std::vector<std::pair<float, int>> backwardOpen;    // second heap of bidirectional searches
+    TerrainCosts terrain;
+    std::vector<uint64_t> bits;     // bit planes of the bit-parallel BFS
+    uint64_t bitsRevision = 0;      // snapshot revision of the free-cell plane in bits
+    std::vector<int> cells;         // cell or node lists: BFS rows, touched slots, chains
+    std::vector<int> nextCells;
+    std::vector<int> stamps;
+    std::vector<int> regionDistance;    // BFS inside one cluster rectangle (HPA*)
+    std::vector<int> regionParent;
+    std::vector<int> regionQueue;
+    SparseCellMap sparse;           // reached cells of the local search
+    LineOfSight lineOfSight;
+
+    // Path buffer handed back by SearchContext; takePath() moves it into a result
+    std::vector<int> path;
+
+    // Set by a solver that restores the buffers to their prepared state after
+    // each query, so its next query on this scratch can skip prepare()
+    const void* cleanFor = nullptr;
+
+    void prepare(int cellCount);
+    size_t memoryBytes() const;
+
+    // Starts a query over cellCount cells in O(1). Only a changed cell count
+    // or the epoch wrapping around costs a pass over the buffers.
+    void beginQuery(int cellCount);
+
+    // Resets a cell to unreached the first time the current query reads it
+    void touch(int cell)
+    {
+        if (stamp[cell] == epoch) return;
+        stamp[cell] = epoch;
+        distance[cell] = INFINITY;
+        parent[cell] = -1;
+        closed[cell] = 0;
+    }
+    bool touched(int cell) const { return stamp[cell] == epoch; }
+
+    // Empties out and gives it the recycled path buffer's memory
+    void takePath(std::vector<int>& out);
+};
+
+// Writes the chain of parent links ending at goal into path, start first.
+// Counts the chain before writing, so the path is filled back to front in
+// place without a reverse or repeated growth.
+void tracePath(const std::vector<int>& parent, int goal, std::vector<int>& path);
+
+// Headless solver entry, listed by race mode and selected by name in batch runs.
+// Solvers that index row-major planes need a row-major snapshot; run them
+// through a SearchContext, which hands them a row-major copy of tiled grids.
+struct SolverEntry
+{
+    std::string name;
+    SearchResult (*run)(const GridSnapshot& snapshot, int startIndex, int endIndex, SearchScratch& scratch);
+    bool anyLayout = false;     // reads every CELLLAYOUTS itself
+};
+
+// Solver with a preprocessing step. prepare() builds its tables once per grid
+// and query() is const, so one prepared solver can serve concurrent runs.
+// The tables are row-major: prepare a tiled grid through withLayout().
+class PreparedSolver
+{
+public:
+    virtual ~PreparedSolver() {}
+
+    virtual std::string name() const = 0;
+    virtual void prepare(const GridSnapshot& snapshot) = 0;
+    virtual bool isPrepared() const = 0;
+    virtual void clear() = 0;
+
+    // Keeps the tables in sync with one cell edit. Solvers that cannot update
+    // in place drop their tables and report isPrepared() == false.
+    virtual void setObstacle(int index, bool obstacle) = 0;
+
+    virtual SearchResult query(int startIndex, int endIndex, SearchScratch& scratch) const = 0;
+
+    // Size of the prepared tables and the time the last prepare() took
+    virtual size_t memoryBytes() const = 0;
+    long long prepareNs() const { return lastPrepareNs; }
+
+    // One-line description of the prepared tables for reports
+    virtual std::string statistics() const { return std::string(); }
+
+protected:
+    long long lastPrepareNs = 0;
+};
+
+// Scratch and last result of one caller issuing many queries. Before each
+// query the previous result's path goes back into the scratch, where the
+// solver picks it up again, so after the first query on a grid further
+// queries make no heap allocations. The result stays valid until the next call.
+// A solver without anyLayout given a tiled snapshot runs on a row-major copy,
+// made once per grid revision, and its path is mapped back to tiled cells.
+class SearchContext
+{
+public:
+    const SearchResult& run(const SolverEntry& solver, const GridSnapshot& snapshot, int startIndex, int endIndex);
+    const SearchResult& query(const PreparedSolver& solver, int startIndex, int endIndex);
+
+    const SearchResult& result() const { return last; }
+    SearchScratch& scratch() { return buffers; }
+
+private:
+    void recycle();
+
+    SearchScratch buffers;
+    SearchResult last;
+    GridSnapshot rowMajor;
+    uint64_t rowMajorOf = 0;        // revision of the tiled grid rowMajor was copied from
+};
+
+// Dijkstra on the 4-connected snapshot, same neighbour order as PathAlgorithm.
+// Weighs steps by the terrain costs when the snapshot has them.
+SearchResult dijkstraSearch(const GridSnapshot& snapshot, int startIndex, int endIndex, SearchScratch& scratch);
+
+// All solvers that can run headless
+const std::vector<SolverEntry>& solverRegistry();
+
+// Registry lookup by name, nullptr when unknown
+const SolverEntry* findSolver(const std::string& name);
+
+// Names of all solvers with a preprocessing step, and a fresh instance by name
+std::vector<std::string> preparedSolverNames();
+std::unique_ptr<PreparedSolver> createPreparedSolver(const std::string& name);
+
+#endif // SEARCHENGINE_H
@@ -0,0 +1,31 @@
+#ifndef SEARCHKERNEL_H
+#define SEARCHKERNEL_H
+
+#include "SearchEngine.h"
+
+// How the kernel reads the cost of entering a cell
+typedef enum {
+    COST_AUTO,      // COST_UNIT without a terrain plane, else COST_FLOAT
+    COST_UNIT,      // every free cell costs 1, terrain is ignored
+    COST_BYTE,      // uint8 terrain costs, one neighbour at a time
+    COST_FLOAT      // float terrain costs, four neighbours per SIMD instruction
+} COSTTYPES;
+
+// A* estimate of the remaining cost; HEURISTIC_NONE runs Dijkstra.
+// Manhattan overestimates on 8-connected grids.
+typedef enum {HEURISTIC_NONE, HEURISTIC_MANHATTAN, HEURISTIC_OCTILE} HEURISTICS;
+
+struct KernelConfig
+{
+    int connectivity = 4;       // 4 or 8
+    COSTTYPES cost = COST_AUTO;
+    HEURISTICS heuristic = HEURISTIC_NONE;
+};
+
+// The only dispatch point: picks the kernel instantiation for config and the
+// snapshot's layout, so the search loop itself has no branch on connectivity,
+// cost type, heuristic or layout. Tiled snapshots are searched in place.
+SearchResult kernelSearch(const KernelConfig& config, const GridSnapshot& snapshot, int startIndex, int endIndex,
+                          SearchScratch& scratch);
+
+#endif // SEARCHKERNEL_H
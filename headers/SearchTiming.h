@@ -0,0 +1,66 @@
+#ifndef SEARCHTIMING_H
+#define SEARCHTIMING_H
+
+#include <chrono>
+
+// Cycles, instructions, cache misses and branch misses of the calling thread,
+// user space only. Read through perf_event_open on Linux; valid stays false
+// where the counters cannot be opened (other platforms, a restrictive
+// perf_event_paranoid, virtual machines without a PMU).
+struct HardwareCounters
+{
+    bool valid = false;
+    long long cycles = 0;
+    long long instructions = 0;
+    long long cacheMisses = 0;
+    long long branchMisses = 0;
+
+    void add(const HardwareCounters& other);
+};
+
+// Running totals of the calling thread since it first asked. The counter
+// group is opened on the first call of each thread and kept until it exits.
+HardwareCounters readHardwareCounters();
+
+typedef enum {PHASE_SETUP, PHASE_SEARCH, PHASE_RECONSTRUCT} SEARCHPHASES;
+
+// Steady-clock time a solver spent in each phase, and the hardware counters
+// over all of them
+struct SearchTiming
+{
+    long long setupNs = 0;          // buffers, cost planes, first push
+    long long searchNs = 0;
+    long long reconstructNs = 0;    // walking the parents back to the start
+    HardwareCounters hardware;
+
+    long long totalNs() const { return setupNs + searchNs + reconstructNs; }
+    void add(const SearchTiming& other);
+};
+
+// Splits the time of one search into phases. Entering a phase ends the one
+// before; pause() and resume() leave out the time between steps of a
+// visualised run. Must stay on one thread while running.
+class PhaseTimer
+{
+public:
+    explicit PhaseTimer(SEARCHPHASES phase = PHASE_SETUP);
+
+    void enter(SEARCHPHASES phase);
+    void pause();
+    void resume(SEARCHPHASES phase);
+
+    // Pauses and returns the totals so far
+    const SearchTiming& finish();
+    const SearchTiming& timing() const { return totals; }
+
+private:
+    void stop();
+
+    SearchTiming totals;
+    SEARCHPHASES current = PHASE_SETUP;
+    bool running = false;
+    std::chrono::steady_clock::time_point since;
+    HardwareCounters countersSince;
+};
+
+#endif // SEARCHTIMING_H
@@ -0,0 +1,99 @@
+#ifndef SPARSECELLMAP_H
+#define SPARSECELLMAP_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Power-of-two blocks kept on a free list per size after release, so memory
+// that is given back and asked for again never returns to the heap. Blocks
+// are only freed with the pool. A copy starts empty: blocks are never shared.
+class BlockPool
+{
+public:
+    BlockPool() {}
+    BlockPool(const BlockPool&) {}
+    BlockPool(BlockPool&& other) noexcept;
+    BlockPool& operator=(const BlockPool&) { return *this; }
+    BlockPool& operator=(BlockPool&& other) noexcept;
+    ~BlockPool();
+
+    // Block of at least bytes, rounded up to a power of two
+    void* allocate(size_t bytes);
+    void release(void* block, size_t bytes);
+
+    // Everything allocated from the heap so far, free or in use
+    size_t reservedBytes() const { return reserved; }
+
+private:
+    void freeAll();
+
+    static constexpr int kClasses = 48;
+    void* freeLists[kClasses] = {};     // each free block starts with the next one
+    size_t reserved = 0;
+};
+
+// Per-cell state of a search that reaches few cells of a large grid: cost
+// so far, parent and closed flag in a flat open-addressing table keyed by
+// cell index, with linear probing and at most half the slots in use. Slot
+// arrays come from a BlockPool, so a table that starts small every query and
+// doubles as it fills makes no heap allocations once the pool has each size.
+class SparseCellMap
+{
+public:
+    struct Slot
+    {
+        int cell;                   // -1: empty
+        int parent;
+        float distance;
+        uint32_t closed;
+    };
+
+    SparseCellMap() {}
+    SparseCellMap(const SparseCellMap&) {}
+    SparseCellMap(SparseCellMap&& other) noexcept;
+    SparseCellMap& operator=(const SparseCellMap& other);
+    SparseCellMap& operator=(SparseCellMap&& other) noexcept;
+    ~SparseCellMap();
+
+    // Empties the table, sized for about expectedCells entries
+    void clear(size_t expectedCells = 128);
+
+    // Slot of cell, nullptr when the query has not reached it
+    const Slot* find(int cell) const;
+
+    // Slot of cell, added unreached (INFINITY, no parent, open) on first
+    // use. Adding can move every slot, so earlier references are invalid.
+    Slot& insert(int cell);
+
+    size_t size() const { return count; }
+    size_t capacity() const { return mask + 1; }
+
+    // Calls f(slot) for every cell in the table
+    template <class F>
+    void forEach(F f) const
+    {
+        if (!slots) return;
+        for (size_t i = 0; i <= mask; ++i)
+            if (slots[i].cell >= 0) f(slots[i]);
+    }
+
+    // Slot array of the current query, and everything the pool holds
+    size_t memoryBytes() const { return slots ? capacity() * sizeof(Slot) : 0; }
+    size_t reservedBytes() const { return pool.reservedBytes(); }
+
+private:
+    size_t home(int cell) const
+    {
+        return static_cast<uint32_t>(cell) * 0x9E3779B1u >> shift;
+    }
+    void resize(size_t slotCount);
+
+    BlockPool pool;                 // declared first, so it outlives slots
+    Slot* slots = nullptr;
+    size_t mask = 0;
+    int shift = 32;
+    size_t count = 0;
+};
+
+#endif // SPARSECELLMAP_H
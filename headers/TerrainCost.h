@@ -0,0 +1,133 @@
+#ifndef TERRAINCOST_H
+#define TERRAINCOST_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#if defined(__SSE2__) || defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+struct GridSnapshot;
+
+// Neighbour directions as compile-time tables. The 4-connected order (east,
+// south, west, north) is the one used by every solver; the diagonals follow
+// it, so the first four entries of EightConnected are FourConnected.
+// A step costs the terrain cost of the cell it enters times its multiplier.
+struct FourConnected
+{
+    static constexpr int count = 4;
+    static constexpr int dx[4] = {1, 0, -1, 0};
+    static constexpr int dy[4] = {0, -1, 0, 1};
+    alignas(16) static constexpr float multiplier[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+};
+
+// Diagonals: south-east, south-west, north-west, north-east. A diagonal step
+// is only allowed when both orthogonal cells it passes are free.
+struct EightConnected
+{
+    static constexpr int count = 8;
+    static constexpr int dx[8] = {1, 0, -1, 0, 1, -1, -1, 1};
+    static constexpr int dy[8] = {0, -1, 0, 1, -1, -1, 1, 1};
+    alignas(32) static constexpr float multiplier[8] = {1.0f, 1.0f, 1.0f, 1.0f,
+                                                        1.41421356f, 1.41421356f, 1.41421356f, 1.41421356f};
+};
+
+// Drops diagonals whose two orthogonal cells are not both open, given a bit
+// per open direction: diagonal i needs orthogonals i and i + 1 (mod 4)
+template <class Dirs>
+inline int withoutCutCorners(int open)
+{
+    if constexpr (Dirs::count == 8) {
+        const int orthogonal = open & 15;
+        const int corners = orthogonal & ((orthogonal >> 1) | (orthogonal << 3)) & 15;
+        return orthogonal | (open & (corners << 4));
+    }
+    return open;
+}
+
+// Entry costs of every cell surrounded by a one cell border, so the
+// neighbours of any cell are read without bounds checks. The float plane
+// holds INFINITY on obstacles and the border; the byte plane 0. The float
+// plane has one spare entry at the end, so the three cells around any cell
+// can be read as a vector of four.
+// The planes are row by row whatever the snapshot's layout, so a tiled grid
+// finds a cell's entry from its coordinates.
+// A plane is only rebuilt when the snapshot's revision changed since it was
+// built, so repeated queries on one grid skip the O(N) pass.
+class TerrainCosts
+{
+public:
+    // Float plane of the snapshot's terrain costs
+    void build(const GridSnapshot& snapshot);
+
+    // Byte plane: 1 for every free cell when unit is set, else its terrain cost
+    void buildBytes(const GridSnapshot& snapshot, bool unit);
+
+    // Entry of a row-major cell, or of the 0-based cell (x, y) in any layout
+    int paddedIndex(int cell) const { return cell + (cell / width) * 2 + stride + 1; }
+    int paddedIndex(int x, int y) const { return (y + 1) * stride + x + 1; }
+
+    // Index step of each EightConnected direction, on the grid and on the padded planes
+    int offset(int dir) const { return cellOffsets[dir]; }
+    int paddedOffset(int dir) const { return padOffsets[dir]; }
+
+    const float* floats() const { return enter.data(); }
+    const uint8_t* bytes() const { return enterBytes.data(); }
+
+    // out[dir] = distance + step cost to the neighbour in direction dir of
+    // the cell at padded entry pad, a vector of four per instruction. Returns
+    // a bit per direction whose neighbour can be entered; corners are not checked.
+    template <class Dirs>
+    int candidates(int pad, float distance, float* out) const;
+
+    size_t memoryBytes() const;
+
+private:
+    void setDimensions(const GridSnapshot& snapshot);
+
+    std::vector<float> enter;       // (width + 2) * (height + 2) + 1
+    std::vector<uint8_t> enterBytes;
+    uint64_t floatRevision = 0;     // snapshot revision each plane was built from, 0: none
+    uint64_t bytesRevision = 0;
+    bool bytesUnit = false;
+    int width = 0;
+    int stride = 0;
+    int cellOffsets[8] = {};
+    int padOffsets[8] = {};
+};
+
+template <class Dirs>
+inline int TerrainCosts::candidates(int pad, float distance, float* out) const
+{
+    const float* p = enter.data() + pad;
+    int open = 0;
+#if defined(__SSE2__) || defined(__AVX__)
+    // One unaligned load per row: west to east plus a lane that is not used
+    const __m128 below = _mm_loadu_ps(p - stride - 1);  // SW S SE
+    const __m128 row = _mm_loadu_ps(p - 1);             // W  .  E
+    const __m128 above = _mm_loadu_ps(p + stride - 1);  // NW N NE
+    const __m128 base = _mm_set1_ps(distance);
+    const __m128 blocked = _mm_set1_ps(INFINITY);
+    auto emit = [&](int k, __m128 cost) {
+        __m128 cand = _mm_add_ps(base, _mm_mul_ps(cost, _mm_load_ps(Dirs::multiplier + k)));
+        _mm_storeu_ps(out + k, cand);
+        open |= _mm_movemask_ps(_mm_cmplt_ps(cand, blocked)) << k;
+    };
+    // Shuffled into direction order: E S W N, then SE SW NW NE
+    const __m128 vertical = _mm_shuffle_ps(below, above, _MM_SHUFFLE(1, 1, 1, 1));  // S S N N
+    const __m128 mixed = _mm_shuffle_ps(row, vertical, _MM_SHUFFLE(2, 0, 0, 2));    // E W S N
+    emit(0, _mm_shuffle_ps(mixed, mixed, _MM_SHUFFLE(3, 1, 2, 0)));
+    if constexpr (Dirs::count == 8)
+        emit(4, _mm_shuffle_ps(below, above, _MM_SHUFFLE(2, 0, 0, 2)));
+#else
+    for (int dir = 0; dir < Dirs::count; ++dir) {
+        out[dir] = distance + p[padOffsets[dir]] * Dirs::multiplier[dir];
+        if (out[dir] < INFINITY) open |= 1 << dir;
+    }
+#endif
+    return open;
+}
+
+#endif // TERRAINCOST_H
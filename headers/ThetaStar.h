@@ -0,0 +1,19 @@
+#ifndef THETASTAR_H
+#define THETASTAR_H
+
+#include "SearchEngine.h"
+
+// Any-angle A* over cell centres with 8-connected expansion and a Euclidean
+// heuristic. A generated cell takes its parent's parent as parent whenever
+// the two see each other, so paths bend only at obstacle corners. The path
+// holds the turning points, pathLength counts segments and pathCost is the
+// Euclidean length. Terrain costs are ignored.
+
+// Theta*: checks line of sight for every generated neighbour
+SearchResult thetaStarSearch(const GridSnapshot& snapshot, int startIndex, int endIndex, SearchScratch& scratch);
+
+// Lazy Theta*: assumes line of sight when generating and checks it once per
+// expanded cell, falling back to the best expanded neighbour when blocked
+SearchResult lazyThetaStarSearch(const GridSnapshot& snapshot, int startIndex, int endIndex, SearchScratch& scratch);
+
+#endif // THETASTAR_H
@@ -0,0 +1,64 @@
+#ifndef TRACEEVENTS_H
+#define TRACEEVENTS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Timeline of scoped spans on every thread, exported as Chrome trace_event
+// JSON (chrome://tracing, Perfetto). Each thread appends to its own buffer
+// of fixed-size chunks: the owner writes an event, then publishes it with a
+// release store of the chunk's count, so recording takes no lock and the
+// exporter can read while threads keep writing. Names and categories must
+// be string literals or otherwise outlive the export.
+// Recording is off until setTraceEnabled(true); a span then costs two clock
+// reads, and a disabled one a single relaxed load.
+
+extern std::atomic<bool> traceRecording;
+
+inline bool traceEnabled() { return traceRecording.load(std::memory_order_relaxed); }
+void setTraceEnabled(bool enabled);
+
+// Label of the calling thread in the viewer; unnamed threads are "Thread N"
+void setTraceThreadName(const char* name);
+
+// Drops everything recorded so far. Each thread empties its own buffer on its
+// next event, and the memory of the old events is freed on the next clear or export.
+void clearTrace();
+
+// One complete event on the calling thread, times from traceClockNs()
+void recordTraceEvent(const char* name, const char* category, int64_t startNs, int64_t durationNs);
+int64_t traceClockNs();
+
+// Writes the events recorded since the last clearTrace(); returns how many
+size_t exportTraceJson(std::ostream& out);
+
+// Events lost since the last clearTrace() because a thread's buffer was full
+long long droppedTraceEvents();
+
+// Records the lifetime of the enclosing scope
+class TraceScope
+{
+public:
+    explicit TraceScope(const char* name, const char* category = "app")
+        : name(name), category(category), startNs(traceEnabled() ? traceClockNs() : -1) {}
+    ~TraceScope()
+    {
+        if (startNs >= 0) recordTraceEvent(name, category, startNs, traceClockNs() - startNs);
+    }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;
+    const char* category;
+    int64_t startNs;
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name, category) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name, category)
+
+#endif // TRACEEVENTS_H
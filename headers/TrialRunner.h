@@ -0,0 +1,57 @@
+#ifndef TRIALRUNNER_H
+#define TRIALRUNNER_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "SearchEngine.h"
+
+// Order statistics of repeated measurements. p95 is the nearest-rank
+// percentile, stddev the sample standard deviation.
+struct SampleSummary
+{
+    int count = 0;
+    double min = 0.0;
+    double median = 0.0;
+    double p95 = 0.0;
+    double mean = 0.0;
+    double stddev = 0.0;
+};
+
+SampleSummary summarizeSamples(std::vector<double> samples);
+
+// What changes between instances of a repeated-trial benchmark
+typedef enum {
+    SWEEP_NONE,         // the grid's own start and goal only
+    SWEEP_ENDPOINTS,    // random free start and goal cells on the grid
+    SWEEP_MAZES         // freshly carved mazes of the grid's size, same start and goal
+} SWEEPMODES;
+
+struct TrialOptions
+{
+    int runs = 20;              // timed runs per instance
+    int warmupRuns = 2;         // untimed runs per instance first, to fill caches and scratch
+    SWEEPMODES sweep = SWEEP_NONE;
+    int sweepCount = 10;        // instances when sweeping
+    uint32_t seed = 1;
+};
+
+struct TrialReport
+{
+    int instances = 0;
+    int pathsFound = 0;         // timed runs that reached the goal
+    SampleSummary timeNs;
+    SampleSummary nodesVisited;
+    SampleSummary pathLength;   // timed runs that reached the goal only
+    SampleSummary memoryBytes;
+    bool cancelled = false;
+};
+
+// Runs solver headless on every instance, one run after another on the
+// calling thread so the timings do not compete with each other. progress is
+// called after each run with the runs done and the total; returning false
+// cancels.
+TrialReport runTrials(const SolverEntry& solver, const GridSnapshot& grid, const TrialOptions& options,
+                      const std::function<bool(int, int)>& progress);
+
+#endif // TRIALRUNNER_H
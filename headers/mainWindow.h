@@ -6,9 +6,20 @@
 #include <QElapsedTimer>
 #include <QTableWidget>
 #include <QTableWidgetItem>
+#include <QListWidget>
+#include <QFutureWatcher>
 #include "GridView.h"
 #include "PathAlgorithm.h"
+#include "RaceView.h"
+#include "IncrementalPlanner.h"
+#include "ComponentIndex.h"
+#include "FlowField.h"
+#include "TrialRunner.h"
+#include <QCheckBox>
 #include <QLabel>
+#include <QComboBox>
+#include <QProgressBar>
+#include <QSpinBox>
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -17,13 +28,18 @@ QT_END_NAMESPACE
 // Structure to hold comparison data for each algorithm run
 struct AlgorithmComparisonData {
     QString algorithmName;
-    qint64  timeElapsedMs;
+    qint64  timeElapsedNs;
     int     nodesVisited;
-    int     pathLength;
+    int     pathLength;             // -1 when not known
+    qreal   pathCost = 0;           // 0 when the run does not report one
+    qint64  lineOfSightChecks = 0;  // any-angle solvers only
+    SearchStats stats;              // all 0 when the run does not count
+    SearchTiming timing;            // phases and hardware counters, all 0 when not measured
     QString gridSize;
     qreal   wallDensity;
     int     numDeadEnds;
     qreal   branchingFactor;
+    qint64  memoryBytes;            // -1 when not known
 };
 
 class MainWindow : public QMainWindow
@@ -38,6 +54,10 @@ public:
     void setupAlgorithmsComboBox();
     void setupGridView(QString gridViewName);
     void setupComparisonTable();
+    void setupRaceControls();
+    void setupFlowFieldControls();
+    void setupTraceControls();
+    void setupBenchmarkControls();
 
     GridView& getGridView();
 
@@ -63,6 +83,15 @@ private slots:
     void on_clearComparisonButton_clicked();
     void on_deleteSelectedRowButton_clicked();
     void extractAndExportMazeFeatures(int nodesVisited, int pathLength);
+    void on_raceButton_clicked();
+    void onCellObstacleChanged(int index, bool obstacle);
+    void onCellCostChanged(int index, int cost);
+    void onEndpointMoved(INTERACTIONS endpoint, int index);
+    void replanAfterEdit();
+    void onFlowFieldToggled(bool checked);
+    void refreshFlowField();
+    void on_exportTraceButton_clicked();
+    void on_benchmarkButton_clicked();
 
 private:
     Ui::MainWindow* ui;
@@ -77,6 +106,45 @@ private:
 
     void updateComparisonTable();
     bool mazeCurrentlyGenerated;
+
+    // O(1) "no path" answer before any search; built lazily, updated on edits
+    ComponentIndex componentIndex;
+    bool goalReachable();
+
+    // Wall density, dead ends and branching factor for the table rows; built
+    // lazily, updated on edits
+    MazeFeatureIndex featureIndex;
+    const MazeFeatureIndex& mazeFeatures();
+
+    // Race mode: solvers to launch together and the split view showing them
+    QListWidget* raceList;
+    RaceView*    raceView;
+    int          raceGeneration;
+
+    // Preprocessing solvers offered in race mode, after the solverRegistry() rows.
+    // Tables are built on the pool for a fresh instance, which replaces the
+    // entry when it is ready unless preparedEdits has moved on since.
+    std::vector<std::shared_ptr<PreparedSolver>> preparedSolvers;
+    int preparedEdits;
+    void resetPreparedSolvers();
+
+    // Keeps the last Dijkstra result alive so grid edits only repair the path
+    IncrementalPlanner replanner;
+    bool               replanPending;
+
+    // Distances and next steps from every cell to the goal, recomputed after edits
+    QCheckBox* flowFieldBox;
+    FlowField  flowField;
+    bool       flowPending;
+
+    // Repeated headless runs of one solver, summarised as min/median/p95/std dev
+    QComboBox*    benchmarkSolverBox;
+    QSpinBox*     benchmarkRunsBox;
+    QComboBox*    benchmarkSweepBox;
+    QSpinBox*     benchmarkSweepCountBox;
+    QPushButton*  benchmarkButton;
+    QProgressBar* benchmarkProgress;
+    QLabel*       benchmarkLabel;
 };
 
 #endif // MAINWINDOW_H
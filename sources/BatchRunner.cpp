@@ -0,0 +1,316 @@
+#include "BatchRunner.h"
+#include "ComponentIndex.h"
+#include "ContractionHierarchy.h"
+#include "GridIO.h"
+#include "HierarchicalPlanner.h"
+#include "LandmarkPlanner.h"
+#include "JobExecutor.h"
+#include "MultiAgentPlanner.h"
+#include "SearchEngine.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+struct PathJob
+{
+    int mapIndex;
+    int startIndex;
+    int endIndex;
+};
+
+std::string resolvePath(const std::string& jobFile, const std::string& mapPath)
+{
+    if (!mapPath.empty() && mapPath[0] == '/') return mapPath;
+    size_t slash = jobFile.find_last_of('/');
+    return slash == std::string::npos ? mapPath : jobFile.substr(0, slash + 1) + mapPath;
+}
+
+// Loads every query and the maps they reference, each map only once
+bool loadJobs(const std::string& jobFile, std::vector<GridSnapshot>& maps, std::vector<std::string>& mapPaths,
+              std::vector<PathJob>& jobs, std::ostream& out)
+{
+    std::ifstream in(jobFile);
+    if (!in) {
+        out << "Cannot open job file " << jobFile << "\n";
+        return false;
+    }
+
+    std::map<std::string, int> mapIndices;
+    std::string line;
+    bool scenario = false;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        if (line.empty() || line[0] == '#') continue;
+        if (lineNumber == 1 && line.compare(0, 7, "version") == 0) {
+            scenario = true;
+            continue;
+        }
+
+        std::istringstream fields(line);
+        std::string mapPath;
+        int bucket, mapWidth, mapHeight, sx, sy, gx, gy;
+        if (scenario)
+            fields >> bucket >> mapPath >> mapWidth >> mapHeight >> sx >> sy >> gx >> gy;
+        else
+            fields >> mapPath >> sx >> sy >> gx >> gy;
+        if (!fields) {
+            out << jobFile << ":" << lineNumber << ": malformed job\n";
+            return false;
+        }
+
+        std::string fullPath = resolvePath(jobFile, mapPath);
+        auto found = mapIndices.find(fullPath);
+        if (found == mapIndices.end()) {
+            GridSnapshot snapshot;
+            std::string error;
+            if (!loadGridSnapshot(fullPath, snapshot, &error)) {
+                out << error << "\n";
+                return false;
+            }
+            maps.push_back(std::move(snapshot));
+            mapPaths.push_back(fullPath);
+            found = mapIndices.emplace(fullPath, static_cast<int>(maps.size()) - 1).first;
+        }
+
+        const GridSnapshot& snapshot = maps[found->second];
+        const int w = snapshot.width;
+        const int h = snapshot.height;
+        // .scen coordinates are 0-based with y growing downwards
+        if (scenario) {
+            sy = h - 1 - sy;
+            gy = h - 1 - gy;
+        } else {
+            sx--; sy--; gx--; gy--;
+        }
+        if (sx < 0 || sx >= w || sy < 0 || sy >= h || gx < 0 || gx >= w || gy < 0 || gy >= h) {
+            out << jobFile << ":" << lineNumber << ": coordinates outside the map\n";
+            return false;
+        }
+        jobs.push_back({found->second, snapshot.cellAt(sx, sy), snapshot.cellAt(gx, gy)});
+    }
+    return true;
+}
+
+// ALT tables are read from the file next to the map when present and written
+// there after a build, so each map is only preprocessed once across runs. The
+// map file itself is only read.
+void prepareForMap(PreparedSolver& solver, const GridSnapshot& snapshot, const std::string& mapPath, std::ostream& out)
+{
+    LandmarkPlanner* landmarks = dynamic_cast<LandmarkPlanner*>(&solver);
+    if (landmarks) {
+        LandmarkTable stored;
+        if (loadLandmarkTable(landmarkPath(mapPath), snapshot, stored) && landmarks->adopt(snapshot, stored)) return;
+    }
+
+    solver.prepare(snapshot);
+
+    std::string error;
+    if (landmarks && !saveLandmarkTable(landmarkPath(mapPath), snapshot, landmarks->landmarks(), &error))
+        out << "Landmark tables not stored: " << error << "\n";
+}
+
+// Every job is one agent; all of them move on the same map at the same time
+int runAgents(const BatchOptions& options, std::ostream& out)
+{
+    std::vector<GridSnapshot> maps;
+    std::vector<std::string> mapPaths;
+    std::vector<PathJob> jobs;
+    if (!loadJobs(options.jobFile, maps, mapPaths, jobs, out)) return 1;
+    if (maps.size() != 1) {
+        out << "Multi-agent jobs must all use the same map\n";
+        return 1;
+    }
+
+    std::vector<MultiAgentPlanner::Agent> agents;
+    for (const PathJob& job : jobs)
+        agents.push_back({job.startIndex, job.endIndex});
+
+    MultiAgentConfig config;
+    config.threads = options.threads;
+    config.batchSize = options.agentBatch;
+    MultiAgentPlanner planner(config);
+    MultiAgentResult result = planner.plan(maps[0], agents);
+
+    out << std::fixed;
+    out << "Agents: " << agents.size() << " on " << maps[0].width << "x" << maps[0].height
+        << " map " << mapPaths[0] << "\n";
+    out << "Planned: " << result.planned << ", failed: " << result.failed
+        << ", replanned after batch conflicts: " << result.replans << "\n";
+    out << "Makespan: " << result.makespan << ", sum of costs: " << result.sumOfCosts
+        << ", nodes expanded: " << result.expansions << "\n";
+    out << "Wall time: " << std::setprecision(3) << result.timeElapsedNs / 1e9 << " s, "
+        << planner.reservationCount() << " reservations, "
+        << std::setprecision(1) << result.memoryBytes / 1024.0 << " KB\n";
+    out << "Conflicts: " << countConflicts(result.paths) << "\n";
+    return 0;
+}
+
+} // namespace
+
+bool parseBatchOptions(int argc, char* argv[], BatchOptions& options)
+{
+    bool batch = false;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--batch") && hasValue) {
+            options.jobFile = argv[++i];
+            batch = true;
+        } else if (!std::strcmp(argv[i], "--solver") && hasValue) {
+            options.solverName = argv[++i];
+        } else if (!std::strcmp(argv[i], "--threads") && hasValue) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--chunk") && hasValue) {
+            options.chunkSize = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--cluster-size") && hasValue) {
+            options.hierarchy.clusterSize = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--levels") && hasValue) {
+            options.hierarchy.levels = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--landmarks") && hasValue) {
+            options.landmarks = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--agents")) {
+            options.agents = true;
+        } else if (!std::strcmp(argv[i], "--agent-batch") && hasValue) {
+            options.agentBatch = std::atoi(argv[++i]);
+        }
+    }
+    return batch;
+}
+
+int runBatch(const BatchOptions& options, std::ostream& out)
+{
+    if (options.agents) return runAgents(options, out);
+
+    const SolverEntry* solver = findSolver(options.solverName);
+    auto createPrepared = [&options]() -> std::unique_ptr<PreparedSolver> {
+        if (options.solverName == "HPA*")
+            return std::unique_ptr<PreparedSolver>(new HierarchicalPlanner(options.hierarchy));
+        if (options.solverName == "ALT")
+            return std::unique_ptr<PreparedSolver>(new LandmarkPlanner(options.landmarks, options.threads));
+        if (options.solverName == "CH")
+            return std::unique_ptr<PreparedSolver>(new ContractionHierarchy(options.threads));
+        return createPreparedSolver(options.solverName);
+    };
+    if (!solver && !createPrepared()) {
+        out << "Unknown solver " << options.solverName << "\n";
+        return 1;
+    }
+
+    std::vector<GridSnapshot> maps;
+    std::vector<std::string> mapPaths;
+    std::vector<PathJob> jobs;
+    if (!loadJobs(options.jobFile, maps, mapPaths, jobs, out)) return 1;
+
+    WorkStealingExecutor executor(options.threads, options.chunkSize);
+
+    // Unreachable queries are rejected before any search starts
+    std::vector<ComponentIndex> components(maps.size());
+    for (size_t m = 0; m < maps.size(); ++m)
+        components[m].build(maps[m], executor.threadCount());
+
+    // Preprocessing solvers build their tables once per map, queries share them
+    std::vector<std::unique_ptr<PreparedSolver>> prepared;
+    long long prepareNs = 0;
+    size_t preparedBytes = 0;
+    if (!solver) {
+        for (size_t m = 0; m < maps.size(); ++m) {
+            prepared.push_back(createPrepared());
+            prepareForMap(*prepared.back(), maps[m], mapPaths[m], out);
+            prepareNs += prepared.back()->prepareNs();
+            preparedBytes += prepared.back()->memoryBytes();
+        }
+    }
+
+    std::vector<SearchContext> contexts(executor.threadCount());
+    // Counters are summed per worker and merged once the batch is done
+    std::vector<SearchStats> workerStats(executor.threadCount());
+    std::vector<SearchTiming> workerTiming(executor.threadCount());
+    std::atomic<long long> pathsFound{0};
+    std::atomic<long long> totalExpanded{0};
+    std::atomic<long long> rejected{0};
+
+    BatchReport report = executor.run(jobs.size(), [&](size_t jobIndex, int worker) {
+        const PathJob& job = jobs[jobIndex];
+        if (!components[job.mapIndex].connected(job.startIndex, job.endIndex)) {
+            rejected.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        const SearchResult& result = solver
+            ? contexts[worker].run(*solver, maps[job.mapIndex], job.startIndex, job.endIndex)
+            : contexts[worker].query(*prepared[job.mapIndex], job.startIndex, job.endIndex);
+        totalExpanded.fetch_add(result.nodesVisited, std::memory_order_relaxed);
+        workerStats[worker].add(result.stats);
+        workerTiming[worker].add(result.timing);
+        if (!result.path.empty()) pathsFound.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    out << std::fixed;
+    out << "Batch: " << report.jobCount << " queries on " << maps.size() << " map(s), "
+        << executor.threadCount() << " thread(s), solver " << options.solverName << "\n";
+    if (!prepared.empty()) {
+        out << "Preprocessing: " << std::setprecision(3) << prepareNs / 1e9 << " s, "
+            << std::setprecision(1) << preparedBytes / 1024.0 << " KB of tables\n";
+        for (size_t m = 0; m < prepared.size(); ++m)
+            out << "Map " << mapPaths[m] << ": " << prepared[m]->statistics() << "\n";
+    }
+    out << "Wall time: " << std::setprecision(3) << report.wallNs / 1e9 << " s, throughput: "
+        << std::setprecision(1) << report.queriesPerSecond() << " queries/s\n";
+    out << "Paths found: " << pathsFound.load() << ", unreachable (no search): " << rejected.load()
+        << ", nodes expanded: " << totalExpanded.load() << "\n";
+    SearchStats stats;
+    for (const SearchStats& worker : workerStats)
+        stats.add(worker);
+    if (stats.pushes > 0) {
+        out << "Search counters: " << stats.pushes << " pushes, " << stats.pops << " pops ("
+            << stats.stalePops << " stale), " << stats.relaxations << " relaxations, "
+            << stats.decreaseKeys << " decrease-keys, peak open set " << stats.peakOpen
+            << ", peak memory " << std::setprecision(1) << stats.peakMemoryBytes / 1024.0 << " KB\n";
+    }
+    SearchTiming timing;
+    for (const SearchTiming& worker : workerTiming)
+        timing.add(worker);
+    if (timing.totalNs() > 0) {
+        out << "Solver time: setup " << std::setprecision(3) << timing.setupNs / 1e9 << " s, search "
+            << timing.searchNs / 1e9 << " s, path " << timing.reconstructNs / 1e9 << " s (summed over threads)\n";
+    }
+    if (timing.hardware.valid) {
+        const HardwareCounters& hw = timing.hardware;
+        out << "Hardware: " << hw.cycles << " cycles, " << hw.instructions << " instructions (IPC "
+            << std::setprecision(2) << (hw.cycles > 0 ? static_cast<double>(hw.instructions) / hw.cycles : 0.0)
+            << "), " << hw.cacheMisses << " cache misses, " << hw.branchMisses << " branch misses\n";
+    }
+    for (int worker = 0; worker < executor.threadCount(); ++worker) {
+        const WorkerReport& stats = report.workers[worker];
+        out << "Thread " << worker << ": " << stats.jobsDone << " queries, "
+            << stats.chunksStolen << " chunks stolen, utilisation "
+            << std::setprecision(1) << 100.0 * report.utilisation(worker) << "%\n";
+    }
+
+    // Speed-up over plain Dijkstra, measured on the same queries on one thread
+    if (!prepared.empty()) {
+        long long preparedNs = 0;
+        long long dijkstraNs = 0;
+        int sampled = 0;
+        SearchScratch preparedScratch, dijkstraScratch;
+        for (size_t i = 0; i < jobs.size() && sampled < 100; ++i) {
+            const PathJob& job = jobs[i];
+            if (!components[job.mapIndex].connected(job.startIndex, job.endIndex)) continue;
+            preparedNs += prepared[job.mapIndex]->query(job.startIndex, job.endIndex, preparedScratch).timeElapsedNs;
+            dijkstraNs += dijkstraSearch(maps[job.mapIndex], job.startIndex, job.endIndex, dijkstraScratch).timeElapsedNs;
+            sampled++;
+        }
+        if (sampled > 0 && preparedNs > 0) {
+            out << "Query speed-up vs Dijkstra: " << std::setprecision(1)
+                << static_cast<double>(dijkstraNs) / preparedNs << "x over " << sampled << " sampled queries\n";
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,237 @@
+#include "BitParallelBfs.h"
+#include <algorithm>
+#include <cmath>
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+// The AVX2 row expansion is built in when the compiler targets AVX2. Without
+// that flag GCC and Clang on x86 still compile it, for AVX2 only, and it is
+// picked at run time when the CPU has AVX2.
+#if defined(__AVX2__)
+#define BFS_AVX2 1
+#define BFS_AVX2_TARGET
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BFS_AVX2 1
+#define BFS_AVX2_DISPATCH 1
+#define BFS_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+namespace {
+
+inline int lowestBit(uint64_t word)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(word);
+#else
+    int bit = 0;
+    while (!(word & 1)) { word >>= 1; ++bit; }
+    return bit;
+#endif
+}
+
+// Next layer of one row: neighbours of the frontier in this row and the rows
+// above and below that are free and not visited yet. Marks them visited and
+// returns whether any cell was added. Every row is framed by a zero word on
+// each side, so the carries across words need no special case at the ends.
+typedef bool (*RowExpander)(const uint64_t* frontier, const uint64_t* below, const uint64_t* above,
+                            const uint64_t* freeCells, uint64_t* visited, uint64_t* next, int words);
+
+// Words from..words - 1 of a row, one at a time; returns the reached bits or'ed
+inline uint64_t expandWords(const uint64_t* frontier, const uint64_t* below, const uint64_t* above,
+                            const uint64_t* freeCells, uint64_t* visited, uint64_t* next, int from, int words)
+{
+    uint64_t any = 0;
+    for (int i = from; i < words; ++i) {
+        uint64_t cur = frontier[i];
+        uint64_t east = (cur << 1) | (frontier[i - 1] >> 63);
+        uint64_t west = (cur >> 1) | (frontier[i + 1] << 63);
+        uint64_t reached = (east | west | below[i] | above[i]) & freeCells[i] & ~visited[i];
+        next[i] = reached;
+        visited[i] |= reached;
+        any |= reached;
+    }
+    return any;
+}
+
+#if !defined(__AVX2__)
+bool expandRowScalar(const uint64_t* frontier, const uint64_t* below, const uint64_t* above,
+                     const uint64_t* freeCells, uint64_t* visited, uint64_t* next, int words)
+{
+    return expandWords(frontier, below, above, freeCells, visited, next, 0, words) != 0;
+}
+#endif
+
+#if defined(BFS_AVX2)
+// Four words per instruction, the words left over one at a time
+BFS_AVX2_TARGET
+bool expandRowAvx2(const uint64_t* frontier, const uint64_t* below, const uint64_t* above,
+                   const uint64_t* freeCells, uint64_t* visited, uint64_t* next, int words)
+{
+    int i = 0;
+    __m256i anyVec = _mm256_setzero_si256();
+    for (; i + 4 <= words; i += 4) {
+        __m256i cur = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(frontier + i));
+        __m256i prev = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(frontier + i - 1));
+        __m256i after = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(frontier + i + 1));
+        __m256i east = _mm256_or_si256(_mm256_slli_epi64(cur, 1), _mm256_srli_epi64(prev, 63));
+        __m256i west = _mm256_or_si256(_mm256_srli_epi64(cur, 1), _mm256_slli_epi64(after, 63));
+        __m256i vertical = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(below + i)),
+                                           _mm256_loadu_si256(reinterpret_cast<const __m256i*>(above + i)));
+        __m256i seen = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(visited + i));
+        __m256i reached = _mm256_andnot_si256(seen, _mm256_and_si256(
+            _mm256_or_si256(_mm256_or_si256(east, west), vertical),
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(freeCells + i))));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(next + i), reached);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(visited + i), _mm256_or_si256(seen, reached));
+        anyVec = _mm256_or_si256(anyVec, reached);
+    }
+    const bool any = !_mm256_testz_si256(anyVec, anyVec);
+    return expandWords(frontier, below, above, freeCells, visited, next, i, words) != 0 || any;
+}
+#endif
+
+// The widest expansion this build and CPU can run, chosen once
+RowExpander rowExpander()
+{
+#if defined(BFS_AVX2_DISPATCH)
+    static const RowExpander best = __builtin_cpu_supports("avx2") ? &expandRowAvx2 : &expandRowScalar;
+    return best;
+#elif defined(BFS_AVX2)
+    return &expandRowAvx2;
+#else
+    return &expandRowScalar;
+#endif
+}
+
+} // namespace
+
+SearchResult bitParallelBfs(const GridSnapshot& snapshot, int start, int goal, SearchScratch& scratch)
+{
+    PhaseTimer timer;
+    SearchResult result;
+
+    const int w = snapshot.width;
+    const int h = snapshot.height;
+    const int words = (w + 63) / 64;
+    // One zero word before and after each row, and a zero row above and below the grid
+    const int stride = words + 2;
+    const size_t plane = static_cast<size_t>(stride) * (h + 2);
+
+    // Layer depths live in distance, stamped so only reached cells are written
+    scratch.beginQuery(snapshot.cellCount());
+    const RowExpander expandRow = rowExpander();
+    // The free-cell plane is kept while the grid is unchanged; the other three are cleared
+    const bool freeValid = scratch.bitsRevision == snapshot.revision && scratch.bits.size() == 4 * plane;
+    if (freeValid)
+        std::fill(scratch.bits.begin() + plane, scratch.bits.end(), 0);
+    else
+        scratch.bits.assign(4 * plane, 0);
+    scratch.bitsRevision = snapshot.revision;
+    uint64_t* freeCells = scratch.bits.data() + stride + 1;
+    uint64_t* visited = freeCells + plane;
+    uint64_t* frontier = visited + plane;
+    uint64_t* next = frontier + plane;
+
+    for (int y = 0; y < h && !freeValid; ++y) {
+        const uint8_t* obstacle = &snapshot.obstacle[static_cast<size_t>(y) * w];
+        uint64_t* row = freeCells + static_cast<size_t>(y) * stride;
+        for (int x = 0; x < w; ++x)
+            row[x >> 6] |= static_cast<uint64_t>(!obstacle[x]) << (x & 63);
+    }
+
+    auto setBit = [stride](uint64_t* bits, int x, int y) {
+        bits[static_cast<size_t>(y) * stride + (x >> 6)] |= uint64_t(1) << (x & 63);
+    };
+    const int goalX = goal >= 0 ? goal % w : -1;
+    const int goalY = goal >= 0 ? goal / w : -1;
+    auto reachedGoal = [&]() {
+        return goal >= 0 && (visited[static_cast<size_t>(goalY) * stride + (goalX >> 6)] >> (goalX & 63)) & 1;
+    };
+
+    setBit(visited, start % w, start / w);
+    setBit(frontier, start % w, start / w);
+    scratch.touch(start);
+    scratch.distance[start] = 0.0f;
+    result.nodesVisited = 1;
+    SEARCH_STAT(result.stats.pushes = 1; result.stats.peakOpen = 1);
+
+    // Rows holding frontier bits and those of the next layer; a row is
+    // expanded once per layer however many frontier rows touch it
+    std::vector<int>& rows = scratch.cells;
+    std::vector<int>& nextRows = scratch.nextCells;
+    std::vector<int>& rowStamp = scratch.stamps;
+    rows.assign(1, start / w);
+    nextRows.clear();
+    rowStamp.assign(h, -1);
+    timer.enter(PHASE_SEARCH);
+
+    for (int depth = 1; !rows.empty() && !reachedGoal(); ++depth) {
+        nextRows.clear();
+        [[maybe_unused]] const int layerStart = result.nodesVisited;
+        // Rows only write their own next and visited words, so the order does not matter
+        for (int frontierRow : rows) {
+            for (int y = std::max(0, frontierRow - 1); y <= std::min(h - 1, frontierRow + 1); ++y) {
+                if (rowStamp[y] == depth) continue;
+                rowStamp[y] = depth;
+                const size_t offset = static_cast<size_t>(y) * stride;
+                if (!expandRow(frontier + offset, frontier + offset - stride, frontier + offset + stride,
+                               freeCells + offset, visited + offset, next + offset, words))
+                    continue;
+                nextRows.push_back(y);
+                for (int i = 0; i < words; ++i) {
+                    for (uint64_t word = next[offset + i]; word; word &= word - 1) {
+                        const int cell = y * w + i * 64 + lowestBit(word);
+                        scratch.touch(cell);
+                        scratch.distance[cell] = static_cast<float>(depth);
+                        result.nodesVisited++;
+                    }
+                }
+            }
+        }
+
+        // A layer is the BFS queue: every reached cell counts as one push
+        SEARCH_STAT(result.stats.pushes += result.nodesVisited - layerStart;
+                    result.stats.peakOpen = std::max<size_t>(result.stats.peakOpen, result.nodesVisited - layerStart));
+
+        // The old frontier becomes the next buffer, which must start empty
+        for (int y : rows)
+            std::fill_n(frontier + static_cast<size_t>(y) * stride, words, 0);
+        std::swap(frontier, next);
+        rows.swap(nextRows);
+    }
+
+    timer.enter(PHASE_RECONSTRUCT);
+    if (goal >= 0 && reachedGoal()) {
+        // Walk back through cells one layer closer, in the solvers' neighbour order.
+        // The depth of the goal gives the length, so the path is filled back to front.
+        const int offsets[4] = {1, -w, -1, w};
+        int cur = goal;
+        size_t slot = static_cast<size_t>(scratch.distance[goal]);
+        scratch.takePath(result.path);
+        result.path.resize(slot + 1);
+        result.path[slot] = cur;
+        while (cur != start) {
+            const float want = scratch.distance[cur] - 1.0f;
+            const int x = cur % w;
+            const int y = cur / w;
+            const bool inside[4] = {x + 1 < w, y > 0, x > 0, y + 1 < h};
+            for (int dir = 0; dir < 4; ++dir) {
+                const int nb = cur + offsets[dir];
+                if (inside[dir] && scratch.touched(nb) && scratch.distance[nb] == want) {
+                    cur += offsets[dir];
+                    break;
+                }
+            }
+            result.path[--slot] = cur;
+        }
+        result.pathLength = static_cast<int>(result.path.size()) - 1;
+        result.pathCost = static_cast<float>(result.pathLength);
+    }
+    result.timing = timer.finish();
+    result.timeElapsedNs = result.timing.totalNs();
+
+    result.memoryBytes = scratch.memoryBytes() + result.path.capacity() * sizeof(int);
+    SEARCH_STAT(result.stats.peakMemoryBytes = result.memoryBytes);
+    return result;
+}
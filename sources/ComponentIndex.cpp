@@ -0,0 +1,168 @@
+#include "ComponentIndex.h"
+#include <algorithm>
+
+ComponentIndex::ComponentIndex() : built(false), stale(false), threads(0) {}
+
+bool ComponentIndex::isBuilt() const { return built; }
+
+void ComponentIndex::clear()
+{
+    built = false;
+    stale = false;
+    parent.clear();
+    snapshot = GridSnapshot();
+}
+
+int ComponentIndex::findNoCompress(int cell) const
+{
+    while (parent[cell] != cell)
+        cell = parent[cell];
+    return cell;
+}
+
+int ComponentIndex::find(int cell)
+{
+    int root = findNoCompress(cell);
+    while (parent[cell] != root) {
+        int next = parent[cell];
+        parent[cell] = root;
+        cell = next;
+    }
+    return root;
+}
+
+// Links the larger root under the smaller one, so roots stay inside the band
+// of their lowest cell and bands can be labelled independently
+void ComponentIndex::unite(int a, int b)
+{
+    int rootA = find(a);
+    int rootB = find(b);
+    if (rootA == rootB) return;
+    if (rootA < rootB) parent[rootB] = rootA;
+    else               parent[rootA] = rootB;
+}
+
+void ComponentIndex::labelBand(int firstRow, int lastRow)
+{
+    const int w = snapshot.width;
+    for (int y = firstRow; y < lastRow; ++y) {
+        for (int x = 0; x < w; ++x) {
+            int cell = y * w + x;
+            if (snapshot.obstacle[cell]) {
+                parent[cell] = -1;
+                continue;
+            }
+            parent[cell] = cell;
+            if (x > 0 && !snapshot.obstacle[cell - 1]) unite(cell, cell - 1);
+            if (y > firstRow && !snapshot.obstacle[cell - w]) unite(cell, cell - w);
+        }
+    }
+}
+
+void ComponentIndex::build(const GridSnapshot& newSnapshot, int threadCount)
+{
+    snapshot = newSnapshot;
+    threads = threadCount;
+    parent.assign(snapshot.cellCount(), -1);
+
+    const int w = snapshot.width;
+    const int h = snapshot.height;
+    // Kept across builds, so a refresh after an edit does not start threads
+    if (!executor || (threads > 0 && executor->threadCount() != threads))
+        executor.reset(new WorkStealingExecutor(threads, 1));
+    const int bands = std::max(1, std::min(executor->threadCount(), h / 64));
+
+    // Each band only touches its own rows
+    std::vector<int> bandStart(bands + 1);
+    for (int band = 0; band <= bands; ++band)
+        bandStart[band] = static_cast<int>(static_cast<long long>(h) * band / bands);
+    executor->run(bands, [&](size_t band, int) {
+        labelBand(bandStart[band], bandStart[band + 1]);
+    });
+
+    // Stitch the band seams together
+    for (int band = 1; band < bands; ++band) {
+        int y = bandStart[band];
+        for (int x = 0; x < w; ++x) {
+            int cell = y * w + x;
+            if (!snapshot.obstacle[cell] && !snapshot.obstacle[cell - w])
+                unite(cell, cell - w);
+        }
+    }
+
+    // Point every cell straight at its root so queries are a single lookup
+    for (int cell = 0; cell < snapshot.cellCount(); ++cell) {
+        if (parent[cell] != -1) parent[cell] = find(cell);
+    }
+
+    built = true;
+    stale = false;
+}
+
+void ComponentIndex::refresh()
+{
+    if (built && stale) build(snapshot, threads);
+}
+
+void ComponentIndex::setObstacle(int index, bool obstacle)
+{
+    if (!built || snapshot.obstacle[index] == (obstacle ? 1 : 0)) return;
+    snapshot.obstacle[index] = obstacle ? 1 : 0;
+    snapshot.markEdited();
+
+    const int w = snapshot.width;
+    const int x = index % w;
+    const int y = index / w;
+    int nbs[4];
+    int count = 0;
+    if (x + 1 < w)               nbs[count++] = index + 1;
+    if (y - 1 >= 0)              nbs[count++] = index - w;
+    if (x - 1 >= 0)              nbs[count++] = index - 1;
+    if (y + 1 < snapshot.height) nbs[count++] = index + w;
+
+    if (!obstacle) {
+        // A cell closed without relabelling may still have cells linked through
+        // it; keep those links and merge it with its free neighbours
+        if (parent[index] == -1) parent[index] = index;
+        for (int i = 0; i < count; ++i) {
+            if (!snapshot.obstacle[nbs[i]]) unite(index, nbs[i]);
+        }
+        return;
+    }
+
+    // The closed cell stays in the union-find tree as an inner node, which is
+    // harmless. Only a cell joining two or more free neighbours can split a region.
+    int freeNeighbours = 0;
+    for (int i = 0; i < count; ++i) {
+        if (!snapshot.obstacle[nbs[i]]) freeNeighbours++;
+    }
+    if (freeNeighbours >= 2) stale = true;
+}
+
+bool ComponentIndex::connected(int start, int goal) const
+{
+    if (!built || stale || start == goal) return true;
+    if (snapshot.obstacle[goal]) return false;
+
+    int goalRoot = findNoCompress(goal);
+    if (!snapshot.obstacle[start]) return findNoCompress(start) == goalRoot;
+
+    const int w = snapshot.width;
+    const int x = start % w;
+    const int y = start / w;
+    if (x + 1 < w && !snapshot.obstacle[start + 1] && findNoCompress(start + 1) == goalRoot) return true;
+    if (y - 1 >= 0 && !snapshot.obstacle[start - w] && findNoCompress(start - w) == goalRoot) return true;
+    if (x - 1 >= 0 && !snapshot.obstacle[start - 1] && findNoCompress(start - 1) == goalRoot) return true;
+    if (y + 1 < snapshot.height && !snapshot.obstacle[start + w] && findNoCompress(start + w) == goalRoot) return true;
+    return false;
+}
+
+int ComponentIndex::componentCount()
+{
+    refresh();
+    int count = 0;
+    for (int cell = 0; cell < snapshot.cellCount(); ++cell) {
+        if (!snapshot.obstacle[cell] && find(cell) == cell) count++;
+    }
+    return count;
+}
@@ -0,0 +1,417 @@
+#include "ContractionHierarchy.h"
+#include "JobExecutor.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <sstream>
+
+namespace {
+
+const int kContractSettleLimit = 500;
+const int kPrioritySettleLimit = 16;
+const int kChunkSize = 256;         // nodes per executor chunk
+
+} // namespace
+
+ContractionHierarchy::ContractionHierarchy(int threadCount)
+    : threads(threadCount), prepared(false), shortcuts(0)
+{
+}
+
+std::string ContractionHierarchy::name() const { return "CH"; }
+bool ContractionHierarchy::isPrepared() const { return prepared; }
+int ContractionHierarchy::nodeCount() const { return static_cast<int>(nodeCell.size()); }
+long long ContractionHierarchy::shortcutCount() const { return shortcuts; }
+
+void ContractionHierarchy::clear()
+{
+    prepared = false;
+    snapshot = GridSnapshot();
+    cellNode.clear();
+    nodeCell.clear();
+    rank.clear();
+    shortcuts = 0;
+    adjacency.clear();
+    inRound.clear();
+    contractedNeighbours.clear();
+    upBegin.clear();
+    upArcs.clear();
+}
+
+void ContractionHierarchy::setObstacle(int index, bool obstacle)
+{
+    if (prepared && snapshot.obstacle[index] != (obstacle ? 1 : 0)) clear();
+}
+
+// -----------------------------------------------------------------
+// Build
+// -----------------------------------------------------------------
+void ContractionHierarchy::findShortcuts(int node, bool skipRound, int settleLimit, WitnessScratch& witness,
+                                         std::vector<Shortcut>& out) const
+{
+    const std::vector<Arc>& arcs = adjacency[node];
+    auto heapCmp = std::greater<std::pair<float, int>>();
+
+    for (size_t i = 0; i + 1 < arcs.size(); ++i) {
+        const int source = arcs[i].target;
+        float bound = 0.0f;
+        for (size_t j = i + 1; j < arcs.size(); ++j)
+            bound = std::max(bound, arcs[i].cost + arcs[j].cost);
+
+        // Bounded Dijkstra from source that avoids node, done once every
+        // remaining neighbour is settled
+        witness.dist[source] = 0.0f;
+        witness.touched.push_back(source);
+        witness.heap.push_back({0.0f, source});
+        int settled = 0;
+        int targetsLeft = static_cast<int>(arcs.size() - i - 1);
+        while (!witness.heap.empty()) {
+            std::pop_heap(witness.heap.begin(), witness.heap.end(), heapCmp);
+            std::pair<float, int> top = witness.heap.back();
+            witness.heap.pop_back();
+            if (top.first > witness.dist[top.second]) continue;
+            if (top.first > bound || ++settled > settleLimit) break;
+            for (size_t j = i + 1; j < arcs.size(); ++j) {
+                if (arcs[j].target == top.second) targetsLeft--;
+            }
+            if (targetsLeft == 0) break;
+
+            for (const Arc& arc : adjacency[top.second]) {
+                if (arc.target == node || (skipRound && inRound[arc.target])) continue;
+                float newCost = top.first + arc.cost;
+                if (newCost < witness.dist[arc.target]) {
+                    if (std::isinf(witness.dist[arc.target])) witness.touched.push_back(arc.target);
+                    witness.dist[arc.target] = newCost;
+                    witness.heap.push_back({newCost, arc.target});
+                    std::push_heap(witness.heap.begin(), witness.heap.end(), heapCmp);
+                }
+            }
+        }
+
+        for (size_t j = i + 1; j < arcs.size(); ++j) {
+            float viaNode = arcs[i].cost + arcs[j].cost;
+            if (witness.dist[arcs[j].target] > viaNode)
+                out.push_back({source, arcs[j].target, viaNode});
+        }
+
+        for (int touched : witness.touched)
+            witness.dist[touched] = INFINITY;
+        witness.touched.clear();
+        witness.heap.clear();
+    }
+}
+
+int ContractionHierarchy::edgeDifference(int node, WitnessScratch& witness) const
+{
+    std::vector<Shortcut> added;
+    findShortcuts(node, false, kPrioritySettleLimit, witness, added);
+    return static_cast<int>(added.size()) - static_cast<int>(adjacency[node].size()) + contractedNeighbours[node];
+}
+
+bool ContractionHierarchy::addOrImprove(int from, int to, float cost, int middle)
+{
+    for (Arc& arc : adjacency[from]) {
+        if (arc.target != to) continue;
+        if (cost < arc.cost) {
+            arc.cost = cost;
+            arc.middle = middle;
+        }
+        return false;
+    }
+    adjacency[from].push_back({to, cost, middle});
+    return true;
+}
+
+void ContractionHierarchy::prepare(const GridSnapshot& newSnapshot)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    clear();
+    snapshot = newSnapshot;
+
+    const int w = snapshot.width;
+    const int h = snapshot.height;
+    cellNode.assign(snapshot.cellCount(), -1);
+    for (int cell = 0; cell < snapshot.cellCount(); ++cell) {
+        if (snapshot.obstacle[cell]) continue;
+        cellNode[cell] = static_cast<int>(nodeCell.size());
+        nodeCell.push_back(cell);
+    }
+
+    const int nodes = static_cast<int>(nodeCell.size());
+    adjacency.assign(nodes, std::vector<Arc>());
+    for (int node = 0; node < nodes; ++node) {
+        int cell = nodeCell[node];
+        int x = cell % w;
+        int y = cell / w;
+        if (x + 1 < w && cellNode[cell + 1] != -1)  adjacency[node].push_back({cellNode[cell + 1], 1.0f, -1});
+        if (y - 1 >= 0 && cellNode[cell - w] != -1) adjacency[node].push_back({cellNode[cell - w], 1.0f, -1});
+        if (x - 1 >= 0 && cellNode[cell - 1] != -1) adjacency[node].push_back({cellNode[cell - 1], 1.0f, -1});
+        if (y + 1 < h && cellNode[cell + w] != -1)  adjacency[node].push_back({cellNode[cell + w], 1.0f, -1});
+    }
+
+    // One executor for the whole build: its threads wait between rounds
+    WorkStealingExecutor executor(threads, kChunkSize);
+    std::vector<WitnessScratch> witness(executor.threadCount());
+    for (WitnessScratch& scratch : witness)
+        scratch.dist.assign(nodes, INFINITY);
+
+    rank.assign(nodes, -1);
+    inRound.assign(nodes, 0);
+    contractedNeighbours.assign(nodes, 0);
+    std::vector<int> priority(nodes);
+    executor.run(nodes, [&](size_t node, int worker) {
+        priority[node] = edgeDifference(static_cast<int>(node), witness[worker]);
+    });
+
+    std::vector<std::vector<Arc>> upward(nodes);
+    std::vector<int> active(nodes);
+    for (int node = 0; node < nodes; ++node)
+        active[node] = node;
+
+    int nextRank = 0;
+    std::vector<int> round;
+    std::vector<std::vector<Shortcut>> found;
+    std::vector<int> changed;
+    while (!active.empty()) {
+        // Nodes whose priority is lowest among their neighbours form an
+        // independent set, so they can be contracted together
+        round.clear();
+        for (int node : active) {
+            bool lowest = true;
+            for (const Arc& arc : adjacency[node]) {
+                int other = arc.target;
+                if (priority[other] < priority[node] || (priority[other] == priority[node] && other < node)) {
+                    lowest = false;
+                    break;
+                }
+            }
+            if (lowest) {
+                round.push_back(node);
+                inRound[node] = 1;
+            }
+        }
+
+        found.assign(round.size(), std::vector<Shortcut>());
+        executor.run(round.size(), [&](size_t i, int worker) {
+            findShortcuts(round[i], true, kContractSettleLimit, witness[worker], found[i]);
+        });
+
+        changed.clear();
+        for (size_t i = 0; i < round.size(); ++i) {
+            int node = round[i];
+            rank[node] = nextRank++;
+            upward[node] = adjacency[node];
+            for (const Arc& arc : adjacency[node]) {
+                std::vector<Arc>& back = adjacency[arc.target];
+                back.erase(std::remove_if(back.begin(), back.end(),
+                                          [node](const Arc& a) { return a.target == node; }),
+                           back.end());
+                contractedNeighbours[arc.target]++;
+                changed.push_back(arc.target);
+            }
+            for (const Shortcut& shortcut : found[i]) {
+                if (addOrImprove(shortcut.from, shortcut.to, shortcut.cost, node)) shortcuts++;
+                addOrImprove(shortcut.to, shortcut.from, shortcut.cost, node);
+            }
+            std::vector<Arc>().swap(adjacency[node]);
+            inRound[node] = 0;
+        }
+
+        // Lazy update: only the neighbours of contracted nodes change priority
+        std::sort(changed.begin(), changed.end());
+        changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+        executor.run(changed.size(), [&](size_t i, int worker) {
+            priority[changed[i]] = edgeDifference(changed[i], witness[worker]);
+        });
+
+        active.erase(std::remove_if(active.begin(), active.end(),
+                                    [this](int node) { return rank[node] != -1; }),
+                     active.end());
+    }
+
+    upBegin.assign(nodes + 1, 0);
+    for (int node = 0; node < nodes; ++node)
+        upBegin[node + 1] = upBegin[node] + static_cast<int>(upward[node].size());
+    upArcs.clear();
+    upArcs.reserve(upBegin[nodes]);
+    for (int node = 0; node < nodes; ++node)
+        upArcs.insert(upArcs.end(), upward[node].begin(), upward[node].end());
+
+    adjacency.clear();
+    inRound.clear();
+    contractedNeighbours.clear();
+
+    prepared = true;
+    lastPrepareNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - t0).count();
+}
+
+// -----------------------------------------------------------------
+// Query
+// -----------------------------------------------------------------
+const ContractionHierarchy::Arc& ContractionHierarchy::findArc(int a, int b) const
+{
+    // Arcs are stored at their lower ranked end
+    int low = rank[a] < rank[b] ? a : b;
+    int high = low == a ? b : a;
+    for (int i = upBegin[low]; i < upBegin[low + 1]; ++i) {
+        if (upArcs[i].target == high) return upArcs[i];
+    }
+    return upArcs[upBegin[low]];
+}
+
+// Appends the cells of arc from -> to, without the cell of from
+void ContractionHierarchy::unpack(int from, int to, std::vector<int>& pending, std::vector<int>& cells) const
+{
+    pending.clear();
+    pending.push_back(from);
+    pending.push_back(to);
+    while (!pending.empty()) {
+        const int arcTo = pending.back();
+        pending.pop_back();
+        const int arcFrom = pending.back();
+        pending.pop_back();
+        const Arc& arc = findArc(arcFrom, arcTo);
+        if (arc.middle == -1) {
+            cells.push_back(nodeCell[arcTo]);
+        } else {
+            pending.push_back(arc.middle);
+            pending.push_back(arcTo);
+            pending.push_back(arcFrom);
+            pending.push_back(arc.middle);
+        }
+    }
+}
+
+SearchResult ContractionHierarchy::query(int start, int goal, SearchScratch& scratch) const
+{
+    auto t0 = std::chrono::steady_clock::now();
+    SearchResult result;
+    auto finish = [&]() {
+        result.memoryBytes = scratch.memoryBytes() + result.path.capacity() * sizeof(int) + memoryBytes();
+        result.timeElapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now() - t0).count();
+        // Moved out, a copy would allocate the path again
+        return std::move(result);
+    };
+    if (!prepared) return finish();
+    if (start == goal) {
+        // The one-cell path, as the other solvers give it
+        scratch.takePath(result.path);
+        result.path.assign(1, start);
+        result.nodesVisited = 1;
+        return finish();
+    }
+    if (cellNode[goal] == -1) return finish();
+
+    // Forward state lives in [0, N), backward state in [N, 2N). Only the
+    // touched entries are reset afterwards, so a reused scratch costs no O(N) pass.
+    const int nodes = nodeCount();
+    if (scratch.cleanFor != this || scratch.distance.size() != static_cast<size_t>(2 * nodes))
+        scratch.prepare(2 * nodes);
+    std::vector<int>& touched = scratch.cells;
+    std::vector<std::pair<float, int>>& backwardOpen = scratch.backwardOpen;
+    touched.clear();
+    backwardOpen.clear();
+    auto heapCmp = std::greater<std::pair<float, int>>();
+
+    auto seed = [&](std::vector<std::pair<float, int>>& open, int slot, float cost) {
+        if (cost >= scratch.distance[slot]) return;
+        scratch.distance[slot] = cost;
+        touched.push_back(slot);
+        open.push_back({cost, slot});
+        std::push_heap(open.begin(), open.end(), heapCmp);
+    };
+
+    // A start drawn on an obstacle is left through its free neighbours
+    const int w = snapshot.width;
+    if (cellNode[start] != -1) {
+        seed(scratch.open, cellNode[start], 0.0f);
+    } else {
+        const int x = start % w;
+        const int y = start / w;
+        if (x + 1 < w && cellNode[start + 1] != -1)               seed(scratch.open, cellNode[start + 1], 1.0f);
+        if (y - 1 >= 0 && cellNode[start - w] != -1)              seed(scratch.open, cellNode[start - w], 1.0f);
+        if (x - 1 >= 0 && cellNode[start - 1] != -1)              seed(scratch.open, cellNode[start - 1], 1.0f);
+        if (y + 1 < snapshot.height && cellNode[start + w] != -1) seed(scratch.open, cellNode[start + w], 1.0f);
+    }
+    seed(backwardOpen, nodes + cellNode[goal], 0.0f);
+
+    float best = INFINITY;
+    int meet = -1;
+    while (true) {
+        float forwardMin = scratch.open.empty() ? INFINITY : scratch.open.front().first;
+        float backwardMin = backwardOpen.empty() ? INFINITY : backwardOpen.front().first;
+        if (std::min(forwardMin, backwardMin) >= best) break;
+
+        const bool forward = forwardMin <= backwardMin;
+        std::vector<std::pair<float, int>>& open = forward ? scratch.open : backwardOpen;
+        const int offset = forward ? 0 : nodes;
+        const int other = forward ? nodes : -nodes;
+
+        std::pop_heap(open.begin(), open.end(), heapCmp);
+        std::pair<float, int> top = open.back();
+        open.pop_back();
+        if (top.first > scratch.distance[top.second]) continue;
+        result.nodesVisited++;
+
+        const int node = top.second - offset;
+        float through = top.first + scratch.distance[top.second + other];
+        if (through < best) {
+            best = through;
+            meet = node;
+        }
+
+        for (int i = upBegin[node]; i < upBegin[node + 1]; ++i) {
+            const Arc& arc = upArcs[i];
+            int slot = offset + arc.target;
+            float newCost = top.first + arc.cost;
+            if (newCost < scratch.distance[slot]) {
+                if (std::isinf(scratch.distance[slot])) touched.push_back(slot);
+                scratch.distance[slot] = newCost;
+                scratch.parent[slot] = node;
+                open.push_back({newCost, slot});
+                std::push_heap(open.begin(), open.end(), heapCmp);
+            }
+        }
+    }
+
+    if (meet != -1) {
+        std::vector<int>& up = scratch.nextCells;
+        std::vector<int>& pending = scratch.stamps;
+        tracePath(scratch.parent, meet, up);
+
+        scratch.takePath(result.path);
+        result.path.push_back(start);
+        if (nodeCell[up.front()] != start) result.path.push_back(nodeCell[up.front()]);
+        for (size_t i = 1; i < up.size(); ++i)
+            unpack(up[i - 1], up[i], pending, result.path);
+        for (int node = meet; scratch.parent[nodes + node] != -1; node = scratch.parent[nodes + node])
+            unpack(node, scratch.parent[nodes + node], pending, result.path);
+
+        result.pathLength = static_cast<int>(result.path.size()) - 1;
+        result.pathCost = best;
+    }
+
+    for (int slot : touched) {
+        scratch.distance[slot] = INFINITY;
+        scratch.parent[slot] = -1;
+    }
+    scratch.open.clear();
+    scratch.cleanFor = this;
+    return finish();
+}
+
+size_t ContractionHierarchy::memoryBytes() const
+{
+    return snapshot.obstacle.capacity() + cellNode.capacity() * sizeof(int) + nodeCell.capacity() * sizeof(int)
+         + rank.capacity() * sizeof(int) + upBegin.capacity() * sizeof(int) + upArcs.capacity() * sizeof(Arc);
+}
+
+std::string ContractionHierarchy::statistics() const
+{
+    std::ostringstream text;
+    text << nodeCount() << " nodes, " << upArcs.size() << " upward arcs, " << shortcuts << " shortcuts";
+    return text.str();
+}
@@ -0,0 +1,233 @@
+#include "DatasetGenerator.h"
+#include "GridGenerator.h"
+#include "JobExecutor.h"
+#include "MazeFeatures.h"
+#include "SearchEngine.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+namespace {
+
+// Rows are handed to the file in blocks of about this size
+const size_t kFlushBytes = 1 << 16;
+
+struct GridGroup
+{
+    int size;
+    float density;      // scatter density, unused for mazes
+    bool maze;
+};
+
+template <class T>
+std::vector<T> parseList(const char* text)
+{
+    std::vector<T> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+        values.push_back(static_cast<T>(std::atof(item.c_str())));
+    return values;
+}
+
+// Column prefix of a solver: "A* 8-way" -> "a_star_8_way"
+std::string columnName(const std::string& solverName)
+{
+    std::string name;
+    for (char c : solverName) {
+        if (std::isalnum(static_cast<unsigned char>(c))) {
+            name += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        } else if (c == '*') {
+            name += name.empty() || name.back() == '_' ? "star" : "_star";
+        } else if (!name.empty() && name.back() != '_') {
+            name += '_';
+        }
+    }
+    while (!name.empty() && name.back() == '_') name.pop_back();
+    return name;
+}
+
+void appendf(std::string& row, const char* format, ...)
+{
+    char text[128];
+    va_list args;
+    va_start(args, format);
+    const int length = std::vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    if (length > 0) row.append(text, std::min<size_t>(length, sizeof(text) - 1));
+}
+
+} // namespace
+
+bool parseDatasetOptions(int argc, char* argv[], DatasetOptions& options)
+{
+    bool dataset = false;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--dataset") && hasValue) {
+            options.outputFile = argv[++i];
+            dataset = true;
+        } else if (!std::strcmp(argv[i], "--sizes") && hasValue) {
+            options.sizes = parseList<int>(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--densities") && hasValue) {
+            options.densities = parseList<float>(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--mazes")) {
+            options.mazes = true;
+        } else if (!std::strcmp(argv[i], "--count") && hasValue) {
+            options.count = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--seed") && hasValue) {
+            options.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (!std::strcmp(argv[i], "--threads") && hasValue) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--chunk") && hasValue) {
+            options.chunkSize = std::atoi(argv[++i]);
+        }
+    }
+    return dataset;
+}
+
+int runDataset(const DatasetOptions& options, std::ostream& out)
+{
+    std::vector<GridGroup> groups;
+    for (int size : options.sizes) {
+        if (size < 2) {
+            out << "Grid size " << size << " is too small\n";
+            return 1;
+        }
+        for (float density : options.densities)
+            groups.push_back({size, density, false});
+        if (options.mazes)
+            groups.push_back({size, 0.0f, true});
+    }
+    if (groups.empty() || options.count <= 0) {
+        out << "Nothing to generate\n";
+        return 1;
+    }
+
+    std::ofstream file(options.outputFile, std::ios::binary);
+    if (!file) {
+        out << "Cannot write " << options.outputFile << "\n";
+        return 1;
+    }
+
+    // The features' path length and expansions are Dijkstra's, as in the GUI
+    const std::vector<SolverEntry>& solvers = solverRegistry();
+    size_t reference = 0;
+    for (size_t s = 0; s < solvers.size(); ++s)
+        if (solvers[s].name == "Dijkstra") reference = s;
+
+    std::string header = "id,generator,width,height,density,seed,wall_density,dead_ends,"
+                         "branching_factor,shortest_path_length,nodes_visited";
+    for (const SolverEntry& solver : solvers) {
+        const std::string column = columnName(solver.name);
+        header += "," + column + "_nodes," + column + "_path_length," + column + "_path_cost," + column + "_ns";
+        for (const char* stat : {"pushes", "pops", "stale_pops", "relaxations", "decrease_keys", "peak_open",
+                                 "peak_bytes"})
+            header += "," + column + "_" + stat;
+    }
+    file << header << "\n";
+
+    WorkStealingExecutor executor(options.threads, options.chunkSize);
+    const int threads = executor.threadCount();
+
+    // Columns kept from each solver's result
+    struct SolverColumns
+    {
+        int nodesVisited;
+        int pathLength;
+        float pathCost;
+        long long timeNs;
+        SearchStats stats;
+    };
+
+    // Each worker reuses its grid, feature index and search context across grids
+    struct Worker
+    {
+        GridSnapshot snapshot;
+        MazeFeatureIndex features;
+        SearchContext context;
+        std::vector<SolverColumns> results;
+        std::string rows;
+        long long solvable = 0;
+    };
+    std::vector<Worker> workers(threads);
+    std::mutex fileMutex;
+    long long bytesWritten = static_cast<long long>(header.size()) + 1;
+    long long solvable = 0;
+
+    auto flush = [&](Worker& worker) {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        file.write(worker.rows.data(), static_cast<std::streamsize>(worker.rows.size()));
+        bytesWritten += static_cast<long long>(worker.rows.size());
+        worker.rows.clear();
+    };
+
+    const size_t jobCount = groups.size() * static_cast<size_t>(options.count);
+    BatchReport report = executor.run(jobCount, [&](size_t jobIndex, int workerIndex) {
+        Worker& worker = workers[workerIndex];
+        const GridGroup& group = groups[jobIndex / options.count];
+        const uint32_t seed = options.seed + static_cast<uint32_t>(jobIndex);
+
+        GridSnapshot& snapshot = worker.snapshot;
+        snapshot.width = group.size;
+        snapshot.height = group.size;
+        snapshot.startIndex = 0;
+        snapshot.endIndex = group.size * group.size - 1;
+        if (group.maze)
+            carveMaze(snapshot, seed);
+        else
+            scatterObstacles(snapshot, group.density, seed);
+        worker.features.build(snapshot);
+
+        worker.results.resize(solvers.size());
+        for (size_t s = 0; s < solvers.size(); ++s) {
+            const SearchResult& result = worker.context.run(solvers[s], snapshot, snapshot.startIndex, snapshot.endIndex);
+            worker.results[s] = {result.nodesVisited, result.pathLength, result.pathCost, result.timeElapsedNs,
+                                 result.stats};
+        }
+        const SolverColumns& dijkstra = worker.results[reference];
+        if (dijkstra.pathLength > 0) worker.solvable++;
+
+        const MazeFeatures features = worker.features.features(dijkstra.pathLength, dijkstra.nodesVisited);
+        std::string& row = worker.rows;
+        appendf(row, "%zu,%s,%d,%d,%.3f,%u,%.4f,%d,%.4f,%d,%d", jobIndex, group.maze ? "maze" : "scatter",
+                features.gridWidth, features.gridHeight, group.maze ? 0.0 : group.density, seed,
+                features.wallDensity, features.numDeadEnds, features.branchingFactor,
+                features.shortestPathLength, features.nodesVisited);
+        for (const SolverColumns& result : worker.results) {
+            const SearchStats& stats = result.stats;
+            appendf(row, ",%d,%d,%.3f,%lld", result.nodesVisited, result.pathLength, result.pathCost, result.timeNs);
+            appendf(row, ",%lld,%lld,%lld,%lld,%lld,%zu,%zu", stats.pushes, stats.pops, stats.stalePops,
+                    stats.relaxations, stats.decreaseKeys, stats.peakOpen, stats.peakMemoryBytes);
+        }
+        row += '\n';
+
+        if (row.size() >= kFlushBytes) flush(worker);
+    });
+
+    for (int w = 0; w < threads; ++w) {
+        if (!workers[w].rows.empty()) flush(workers[w]);
+        solvable += workers[w].solvable;
+    }
+    file.flush();
+    if (!file) {
+        out << "Writing " << options.outputFile << " failed\n";
+        return 1;
+    }
+
+    out << std::fixed;
+    out << "Dataset: " << report.jobCount << " grids in " << groups.size() << " group(s), "
+        << solvers.size() << " solvers each, " << threads << " thread(s)\n";
+    out << "Solvable: " << solvable << ", written: " << std::setprecision(1) << bytesWritten / (1024.0 * 1024.0)
+        << " MB to " << options.outputFile << "\n";
+    out << "Wall time: " << std::setprecision(3) << report.wallNs / 1e9 << " s, throughput: "
+        << std::setprecision(1) << report.queriesPerSecond() << " grids/s\n";
+    return 0;
+}
@@ -0,0 +1,251 @@
+#include "FlowField.h"
+#include "JobExecutor.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+enum { SIDE_EAST = 1, SIDE_SOUTH = 2, SIDE_WEST = 4, SIDE_NORTH = 8 };
+
+} // namespace
+
+FlowField::FlowField(int size, int threadCount)
+    : tileSize(std::max(8, size)), computed(false), goalIndex(-1),
+      roundCount(0), reachable(0), lastComputeNs(0), tilesX(0), tilesY(0), executor(threadCount, 1),
+      queues(executor.threadCount())
+{
+}
+
+bool FlowField::isComputed() const { return computed; }
+int FlowField::goal() const { return goalIndex; }
+int FlowField::width() const { return snapshot.width; }
+long long FlowField::computeNs() const { return lastComputeNs; }
+int FlowField::rounds() const { return roundCount; }
+int FlowField::reachableCells() const { return reachable; }
+
+void FlowField::clear()
+{
+    computed = false;
+    goalIndex = -1;
+    roundCount = 0;
+    reachable = 0;
+    snapshot = GridSnapshot();
+    distance.clear();
+    direction.clear();
+    tiles.clear();
+}
+
+float FlowField::distanceAt(int cell) const
+{
+    return distance[cell];
+}
+
+FLOWDIRECTIONS FlowField::directionAt(int cell) const
+{
+    return static_cast<FLOWDIRECTIONS>(direction[cell]);
+}
+
+int FlowField::nextCell(int cell) const
+{
+    switch (direction[cell]) {
+    case FLOW_EAST:  return cell + 1;
+    case FLOW_SOUTH: return cell - snapshot.width;
+    case FLOW_WEST:  return cell - 1;
+    case FLOW_NORTH: return cell + snapshot.width;
+    default:         return -1;
+    }
+}
+
+std::vector<int> FlowField::pathFrom(int cell) const
+{
+    std::vector<int> path;
+    if (!computed || (cell != goalIndex && direction[cell] == FLOW_NONE)) return path;
+    for (int cur = cell; cur != -1; cur = nextCell(cur))
+        path.push_back(cur);
+    return path;
+}
+
+// -----------------------------------------------------------------
+// Tile-parallel wavefront
+// -----------------------------------------------------------------
+void FlowField::pullHalo(Tile& tile) const
+{
+    const int w = snapshot.width;
+    const int h = snapshot.height;
+    const int tw = tile.x1 - tile.x0;
+    const int th = tile.y1 - tile.y0;
+    float* east = tile.halo.data();
+    float* south = east + th;
+    float* west = south + tw;
+    float* north = west + th;
+
+    for (int y = tile.y0; y < tile.y1; ++y) {
+        east[y - tile.y0] = tile.x1 < w ? distance[y * w + tile.x1] : INFINITY;
+        west[y - tile.y0] = tile.x0 > 0 ? distance[y * w + tile.x0 - 1] : INFINITY;
+    }
+    for (int x = tile.x0; x < tile.x1; ++x) {
+        south[x - tile.x0] = tile.y0 > 0 ? distance[(tile.y0 - 1) * w + x] : INFINITY;
+        north[x - tile.x0] = tile.y1 < h ? distance[tile.y1 * w + x] : INFINITY;
+    }
+}
+
+// Label-correcting BFS inside the tile, seeded from the halo. Only writes
+// cells of this tile, so all active tiles can relax at the same time.
+void FlowField::relaxTile(Tile& tile, std::vector<int>& queue)
+{
+    const int w = snapshot.width;
+    const int tw = tile.x1 - tile.x0;
+    const int th = tile.y1 - tile.y0;
+    const float* east = tile.halo.data();
+    const float* south = east + th;
+    const float* west = south + tw;
+    const float* north = west + th;
+
+    queue.clear();
+    uint8_t changed = 0;
+    auto improve = [&](int cell, float value) {
+        distance[cell] = value;
+        queue.push_back(cell);
+        int x = cell % w;
+        int y = cell / w;
+        if (x == tile.x1 - 1) changed |= SIDE_EAST;
+        if (y == tile.y0)     changed |= SIDE_SOUTH;
+        if (x == tile.x0)     changed |= SIDE_WEST;
+        if (y == tile.y1 - 1) changed |= SIDE_NORTH;
+    };
+
+    int gx = goalIndex % w;
+    int gy = goalIndex / w;
+    if (gx >= tile.x0 && gx < tile.x1 && gy >= tile.y0 && gy < tile.y1 && distance[goalIndex] > 0.0f)
+        improve(goalIndex, 0.0f);
+
+    auto seed = [&](int cell, float neighbour) {
+        if (!snapshot.obstacle[cell] && neighbour + 1.0f < distance[cell]) improve(cell, neighbour + 1.0f);
+    };
+    for (int y = tile.y0; y < tile.y1; ++y) {
+        seed(y * w + tile.x1 - 1, east[y - tile.y0]);
+        seed(y * w + tile.x0, west[y - tile.y0]);
+    }
+    for (int x = tile.x0; x < tile.x1; ++x) {
+        seed(tile.y0 * w + x, south[x - tile.x0]);
+        seed((tile.y1 - 1) * w + x, north[x - tile.x0]);
+    }
+
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int cur = queue[head];
+        int x = cur % w;
+        int y = cur / w;
+        float next = distance[cur] + 1.0f;
+        int nbs[4];
+        int count = 0;
+        if (x + 1 < tile.x1)  nbs[count++] = cur + 1;
+        if (y - 1 >= tile.y0) nbs[count++] = cur - w;
+        if (x - 1 >= tile.x0) nbs[count++] = cur - 1;
+        if (y + 1 < tile.y1)  nbs[count++] = cur + w;
+        for (int i = 0; i < count; ++i) {
+            if (!snapshot.obstacle[nbs[i]] && next < distance[nbs[i]]) improve(nbs[i], next);
+        }
+    }
+    tile.changedSides = changed;
+}
+
+void FlowField::computeDirections(int firstRow, int lastRow)
+{
+    const int w = snapshot.width;
+    const int h = snapshot.height;
+    for (int y = firstRow; y < lastRow; ++y) {
+        for (int x = 0; x < w; ++x) {
+            int cell = y * w + x;
+            float best = distance[cell];
+            uint8_t dir = FLOW_NONE;
+            if (x + 1 < w && distance[cell + 1] < best)  { best = distance[cell + 1]; dir = FLOW_EAST; }
+            if (y - 1 >= 0 && distance[cell - w] < best) { best = distance[cell - w]; dir = FLOW_SOUTH; }
+            if (x - 1 >= 0 && distance[cell - 1] < best) { best = distance[cell - 1]; dir = FLOW_WEST; }
+            if (y + 1 < h && distance[cell + w] < best)  { best = distance[cell + w]; dir = FLOW_NORTH; }
+            direction[cell] = dir;
+        }
+    }
+}
+
+void FlowField::compute(const GridSnapshot& newSnapshot, int goal)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    clear();
+    snapshot = newSnapshot;
+    goalIndex = goal;
+
+    const int w = snapshot.width;
+    const int h = snapshot.height;
+    distance.assign(snapshot.cellCount(), INFINITY);
+    direction.assign(snapshot.cellCount(), FLOW_NONE);
+
+    tilesX = (w + tileSize - 1) / tileSize;
+    tilesY = (h + tileSize - 1) / tileSize;
+    tiles.resize(static_cast<size_t>(tilesX) * tilesY);
+    for (int ty = 0; ty < tilesY; ++ty) {
+        for (int tx = 0; tx < tilesX; ++tx) {
+            Tile& tile = tiles[ty * tilesX + tx];
+            tile.x0 = tx * tileSize;
+            tile.y0 = ty * tileSize;
+            tile.x1 = std::min(w, tile.x0 + tileSize);
+            tile.y1 = std::min(h, tile.y0 + tileSize);
+            tile.halo.assign(2 * (tile.x1 - tile.x0) + 2 * (tile.y1 - tile.y0), INFINITY);
+            tile.changedSides = 0;
+        }
+    }
+
+    if (goal >= 0 && goal < snapshot.cellCount() && !snapshot.obstacle[goal]) {
+        std::vector<int> active = {(goal / w / tileSize) * tilesX + (goal % w) / tileSize};
+        std::vector<int> next;
+        std::vector<int> queuedInRound(tiles.size(), -1);
+
+        while (!active.empty()) {
+            roundCount++;
+            // Halos are read in one pass and cells written in the next, so no
+            // tile reads a cell while its owner relaxes it
+            executor.run(active.size(), [&](size_t i, int) { pullHalo(tiles[active[i]]); });
+            executor.run(active.size(), [&](size_t i, int worker) { relaxTile(tiles[active[i]], queues[worker]); });
+
+            next.clear();
+            auto enqueue = [&](int tile) {
+                if (queuedInRound[tile] == roundCount) return;
+                queuedInRound[tile] = roundCount;
+                next.push_back(tile);
+            };
+            for (int index : active) {
+                const uint8_t sides = tiles[index].changedSides;
+                const int tx = index % tilesX;
+                const int ty = index / tilesX;
+                if ((sides & SIDE_EAST) && tx + 1 < tilesX) enqueue(index + 1);
+                if ((sides & SIDE_SOUTH) && ty > 0)          enqueue(index - tilesX);
+                if ((sides & SIDE_WEST) && tx > 0)           enqueue(index - 1);
+                if ((sides & SIDE_NORTH) && ty + 1 < tilesY) enqueue(index + tilesX);
+            }
+            active.swap(next);
+        }
+    }
+
+    const int bands = std::max(1, std::min(executor.threadCount() * 4, h));
+    executor.run(bands, [&](size_t band, int) {
+        computeDirections(static_cast<int>(static_cast<long long>(h) * band / bands),
+                          static_cast<int>(static_cast<long long>(h) * (band + 1) / bands));
+    });
+
+    reachable = static_cast<int>(std::count_if(distance.begin(), distance.end(),
+                                               [](float d) { return std::isfinite(d); }));
+    computed = true;
+    lastComputeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - t0).count();
+}
+
+size_t FlowField::memoryBytes() const
+{
+    size_t bytes = distance.capacity() * sizeof(float) + direction.capacity() + snapshot.obstacle.capacity()
+                 + tiles.capacity() * sizeof(Tile);
+    for (const Tile& tile : tiles)
+        bytes += tile.halo.capacity() * sizeof(float);
+    for (const std::vector<int>& queue : queues)
+        bytes += queue.capacity() * sizeof(int);
+    return bytes;
+}
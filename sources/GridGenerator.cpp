@@ -0,0 +1,90 @@
+#include "GridGenerator.h"
+#include <random>
+
+void scatterObstacles(GridSnapshot& snapshot, float density, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    // Threshold on the raw 32-bit draw, so no distribution object is involved
+    const uint64_t threshold = static_cast<uint64_t>(density * 4294967296.0);
+    snapshot.obstacle.resize(snapshot.cellCount());
+    if (snapshot.layout == LAYOUT_ROW_MAJOR) {
+        for (uint8_t& cell : snapshot.obstacle)
+            cell = rng() < threshold;
+    } else {
+        // Draws in row-major order, so a seed gives the same grid in every layout
+        for (int y = 0; y < snapshot.height; ++y)
+            for (int x = 0; x < snapshot.width; ++x)
+                snapshot.obstacle[snapshot.cellAt(x, y)] = rng() < threshold;
+    }
+    snapshot.obstacle[snapshot.startIndex] = 0;
+    snapshot.obstacle[snapshot.endIndex] = 0;
+    snapshot.markEdited();
+}
+
+void carveMaze(GridSnapshot& snapshot, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    const int w = snapshot.width;
+    const int h = snapshot.height;
+    snapshot.obstacle.assign(snapshot.cellCount(), 1);
+    snapshot.obstacle[snapshot.startIndex] = 0;
+    snapshot.obstacle[snapshot.endIndex] = 0;
+    snapshot.markEdited();
+
+    // Visited cells of the carving walk; obstacle cannot tell, start and end are free already
+    std::vector<uint8_t> visited(snapshot.cellCount(), 0);
+    std::vector<int> stack;
+    stack.push_back(snapshot.startIndex);
+    visited[snapshot.startIndex] = 1;
+
+    const int dx[4] = {2, 0, -2, 0};
+    const int dy[4] = {0, -2, 0, 2};
+    while (!stack.empty()) {
+        const int cur = stack.back();
+        int x, y;
+        snapshot.cellCoords(cur, x, y);
+        int possibleDirs[4];
+        int dirCount = 0;
+        for (int dir = 0; dir < 4; ++dir) {
+            const int nx = x + dx[dir];
+            const int ny = y + dy[dir];
+            if (nx >= 0 && nx < w && ny >= 0 && ny < h && !visited[snapshot.cellAt(nx, ny)])
+                possibleDirs[dirCount++] = dir;
+        }
+        if (dirCount == 0) {
+            stack.pop_back();
+            continue;
+        }
+
+        const int dir = possibleDirs[rng() % dirCount];
+        const int dest = snapshot.cellAt(x + dx[dir], y + dy[dir]);
+        snapshot.obstacle[snapshot.cellAt(x + dx[dir] / 2, y + dy[dir] / 2)] = 0;
+        snapshot.obstacle[dest] = 0;
+        visited[dest] = 1;
+        stack.push_back(dest);
+    }
+
+    // The passages lie on the start's lattice of every other cell. A goal off
+    // it is joined through one free neighbour next to a passage.
+    int gx, gy;
+    snapshot.cellCoords(snapshot.endIndex, gx, gy);
+    auto inside = [w, h](int x, int y) { return x >= 0 && x < w && y >= 0 && y < h; };
+    for (int dir = 0; dir < 4; ++dir) {
+        const int nx = gx + dx[dir] / 2;
+        const int ny = gy + dy[dir] / 2;
+        if (inside(nx, ny) && visited[snapshot.cellAt(nx, ny)]) return;
+    }
+    for (int dir = 0; dir < 4; ++dir) {
+        const int nx = gx + dx[dir] / 2;
+        const int ny = gy + dy[dir] / 2;
+        if (!inside(nx, ny)) continue;
+        for (int next = 0; next < 4; ++next) {
+            const int mx = nx + dx[next] / 2;
+            const int my = ny + dy[next] / 2;
+            if (inside(mx, my) && visited[snapshot.cellAt(mx, my)]) {
+                snapshot.obstacle[snapshot.cellAt(nx, ny)] = 0;
+                return;
+            }
+        }
+    }
+}
@@ -0,0 +1,130 @@
+#include "GridIO.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+static bool fail(std::string* error, const std::string& message)
+{
+    if (error) *error = message;
+    return false;
+}
+
+bool loadGridSnapshot(const std::string& path, GridSnapshot& snapshot, std::string* error)
+{
+    std::ifstream in(path);
+    if (!in) return fail(error, "cannot open " + path);
+
+    int width = -1, height = -1;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream header(line);
+        std::string key;
+        header >> key;
+        if (key == "height") header >> height;
+        else if (key == "width") header >> width;
+        else if (key == "map") break;
+    }
+    if (width <= 0 || height <= 0) return fail(error, "missing width/height in " + path);
+
+    const CELLLAYOUTS layout = snapshot.layout;
+    snapshot = GridSnapshot();
+    snapshot.layout = layout;
+    snapshot.width = width;
+    snapshot.height = height;
+    snapshot.obstacle.assign(static_cast<size_t>(width) * height, 1);
+
+    // File rows go top to bottom, the grid's y axis goes bottom to top
+    for (int row = 0; row < height; ++row) {
+        if (!std::getline(in, line)) return fail(error, "truncated map in " + path);
+        int y = height - 1 - row;
+        for (int x = 0; x < width && x < static_cast<int>(line.size()); ++x) {
+            char c = line[x];
+            const int cell = snapshot.cellAt(x, y);
+            if (c >= '1' && c <= '9') {
+                if (snapshot.cost.empty()) snapshot.cost.assign(snapshot.obstacle.size(), 1);
+                snapshot.cost[cell] = static_cast<uint8_t>(c - '0');
+                snapshot.obstacle[cell] = 0;
+            } else {
+                snapshot.obstacle[cell] = (c == '.' || c == 'G' || c == 'S') ? 0 : 1;
+            }
+        }
+    }
+    snapshot.startIndex = snapshot.cellAt(0, 0);
+    snapshot.endIndex = snapshot.cellAt(width - 1, height - 1);
+    return true;
+}
+
+bool saveGridSnapshot(const std::string& path, const GridSnapshot& snapshot, std::string* error)
+{
+    std::ofstream out(path);
+    if (!out) return fail(error, "cannot write " + path);
+
+    out << "type octile\nheight " << snapshot.height << "\nwidth " << snapshot.width << "\nmap\n";
+    std::string row(snapshot.width, '.');
+    for (int y = snapshot.height - 1; y >= 0; --y) {
+        for (int x = 0; x < snapshot.width; ++x) {
+            int cell = snapshot.cellAt(x, y);
+            int cost = std::min(static_cast<int>(snapshot.costAt(cell)), GridSnapshot::kMaxTerrainCost);
+            row[x] = snapshot.obstacle[cell] ? '@' : cost > 1 ? static_cast<char>('0' + cost) : '.';
+        }
+        out << row << '\n';
+    }
+    return static_cast<bool>(out);
+}
+
+std::string landmarkPath(const std::string& mapPath)
+{
+    return mapPath + ".alt";
+}
+
+bool saveLandmarkTable(const std::string& path, const GridSnapshot& snapshot, const LandmarkTable& table,
+                       std::string* error)
+{
+    // Landmark rows are stored in cell order, which readers take as row-major
+    if (snapshot.layout != LAYOUT_ROW_MAJOR) return fail(error, "landmark tables need a row-major grid");
+    if (table.count <= 0) return fail(error, "no landmark table to write");
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return fail(error, "cannot write " + path);
+
+    out << "landmarks " << table.count << ' ' << obstacleChecksum(snapshot) << '\n';
+    for (int cell : table.cells)
+        out << cell % snapshot.width << ' ' << snapshot.height - 1 - cell / snapshot.width << '\n';
+    for (int cell = 0; cell < snapshot.cellCount(); ++cell)
+        out.write(reinterpret_cast<const char*>(table.row(cell)), table.count * sizeof(float));
+    return static_cast<bool>(out);
+}
+
+bool loadLandmarkTable(const std::string& path, const GridSnapshot& snapshot, LandmarkTable& table, std::string* error)
+{
+    if (snapshot.layout != LAYOUT_ROW_MAJOR) return fail(error, "landmark tables need a row-major grid");
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return fail(error, "cannot open " + path);
+
+    std::string line;
+    std::string key;
+    int count = 0;
+    unsigned long long checksum = 0;
+    if (!std::getline(in, line)) return fail(error, "no landmark table in " + path);
+    std::istringstream header(line);
+    header >> key >> count >> checksum;
+    if (key != "landmarks" || count <= 0) return fail(error, "no landmark table in " + path);
+    if (checksum != obstacleChecksum(snapshot)) return fail(error, "landmark table of " + path + " is out of date");
+
+    table = LandmarkTable();
+    table.count = count;
+    table.stride = LandmarkTable::strideFor(count);
+    for (int k = 0; k < count; ++k) {
+        int x, row;
+        if (!std::getline(in, line) || !(std::istringstream(line) >> x >> row))
+            return fail(error, "truncated landmark table in " + path);
+        table.cells.push_back((snapshot.height - 1 - row) * snapshot.width + x);
+    }
+
+    table.distance.assign(static_cast<size_t>(snapshot.cellCount()) * table.stride, 0.0f);
+    for (int cell = 0; cell < snapshot.cellCount(); ++cell) {
+        float* row = &table.distance[static_cast<size_t>(cell) * table.stride];
+        if (!in.read(reinterpret_cast<char*>(row), count * sizeof(float)))
+            return fail(error, "truncated landmark table in " + path);
+    }
+    return true;
+}
@@ -4,7 +4,13 @@
 #include <cmath>
 #include <QMessageBox>
 #include "GridView.h"
+#include "FlowField.h"
+#include "SearchEngine.h"
+#include "TraceEvents.h"
+#include <QLegendMarker>
+#include <QPainter>
 #include <QCategoryAxis>
+#include <algorithm>
 #include <queue>
 
 // Constructor
@@ -31,6 +37,12 @@ GridView::GridView(int widthGrid, int heightGrid, int markerSize, QChartView* pa
 
     pathLine = new QLineSeries();
 
+    for (size_t level = 1; level < terrainLevels().size(); ++level)
+        terrainElements.push_back(new QScatterSeries());
+
+    for (int dir = FLOW_EAST; dir < FLOW_NONE; ++dir)
+        flowElements.push_back(new QScatterSeries());
+
     currentInteraction  = NOINTERACTION;
     currentArrangement  = EMPTY;
     currentAlgorithm    = NOALGO;
@@ -100,6 +112,7 @@ int GridView::getHeightGrid() const
 
 void GridView::populateGridMap(ARRANGEMENTS arrangement, bool reset)
 {
+    TRACE_SCOPE("populate grid", "view");
     if (simulationRunning)
     {
         QMessageBox::information(this, "Information", "Please stop the simulation first");
@@ -113,6 +126,9 @@ void GridView::populateGridMap(ARRANGEMENTS arrangement, bool reset)
         nextElements->removePoints(0, nextElements->points().size());
         pathElements->removePoints(0, pathElements->points().size());
         pathLine->removePoints(0, pathLine->points().size());
+        for (QScatterSeries* terrain : terrainElements)
+            terrain->clear();
+        clearFlowField();
 
         gridNodes.Nodes.clear();
 
@@ -216,12 +232,28 @@ QChart* GridView::createChart()
     endElement->setBorderColor(QColorConstants::Black);
 
     chart->addSeries(freeElements);
+    for (size_t i = 0; i < terrainElements.size(); ++i) {
+        QScatterSeries* terrain = terrainElements[i];
+        const int level = terrainLevels()[i + 1];
+        terrain->setMarkerShape(QScatterSeries::MarkerShapeRectangle);
+        terrain->setBorderColor(QColorConstants::Black);
+        // Darker brown for costlier terrain
+        terrain->setColor(QColor("#cd6133").darker(100 + 100 * int(i) / int(terrainElements.size())));
+        terrain->setOpacity(0.6);
+        terrain->setName(QString("Cost %1").arg(level));
+        chart->addSeries(terrain);
+    }
     chart->addSeries(obstacleElements);
     chart->addSeries(visitedElements);
     chart->addSeries(nextElements);
     chart->addSeries(pathElements);
     chart->addSeries(startElement);
     chart->addSeries(endElement);
+    for (QScatterSeries* arrows : flowElements) {
+        arrows->setMarkerShape(QScatterSeries::MarkerShapeRectangle);
+        arrows->setBorderColor(Qt::transparent);
+        chart->addSeries(arrows);
+    }
     chart->addSeries(pathLine);
 
     startElement->setName("Start");
@@ -240,6 +272,13 @@ QChart* GridView::createChart()
     chart->legend()->setAlignment(Qt::AlignBottom);
     chart->legend()->setMarkerShape(QLegend::MarkerShapeFromSeries);
 
+    // A single legend entry for the four arrow series
+    flowElements[FLOW_EAST]->setName("Flow");
+    for (int dir = FLOW_SOUTH; dir < FLOW_NONE; ++dir) {
+        for (QLegendMarker* marker : chart->legend()->markers(flowElements[dir]))
+            marker->setVisible(false);
+    }
+
     QLinearGradient bg;
     bg.setStart(0,0); bg.setFinalStop(0,1);
     bg.setColorAt(0.0, QRgb(0xa8edea));
@@ -261,6 +300,8 @@ QChart* GridView::createChart()
 
     connect(freeElements, &QScatterSeries::clicked, this, &GridView::handleClickedPoint);
     connect(obstacleElements, &QScatterSeries::clicked, this, &GridView::handleClickedPoint);
+    for (QScatterSeries* terrain : terrainElements)
+        connect(terrain, &QScatterSeries::clicked, this, &GridView::handleClickedPoint);
 
     return chart;
 }
@@ -274,10 +315,75 @@ void GridView::setElementsMarkerSize()
     pathElements->setMarkerSize(markerSize);
     startElement->setMarkerSize(markerSize);
     endElement->setMarkerSize(markerSize);
+    for (QScatterSeries* terrain : terrainElements)
+        terrain->setMarkerSize(markerSize);
+
+    // Arrow images are drawn at marker size, pointing east then turned
+    // clockwise on screen: south (y - 1) is down, north is up
+    const int size = qMax(4, int(markerSize));
+    for (int dir = FLOW_EAST; dir < FLOW_NONE; ++dir) {
+        QImage arrow(size, size, QImage::Format_ARGB32);
+        arrow.fill(Qt::transparent);
+        QPainter painter(&arrow);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.translate(size / 2.0, size / 2.0);
+        painter.rotate(90.0 * dir);
+        painter.setPen(QPen(QColor("#706fd3"), qMax(1.0, size / 10.0)));
+        painter.setBrush(QColor("#706fd3"));
+        painter.drawLine(QPointF(-size * 0.35, 0), QPointF(size * 0.1, 0));
+        painter.drawPolygon(QPolygonF({QPointF(size * 0.35, 0), QPointF(0, -size * 0.2), QPointF(0, size * 0.2)}));
+        painter.end();
+
+        flowElements[dir]->setMarkerSize(markerSize);
+        flowElements[dir]->setBrush(arrow);
+    }
+}
+
+const std::vector<uint8_t>& GridView::terrainLevels()
+{
+    static const std::vector<uint8_t> levels = {1, 3, GridSnapshot::kMaxTerrainCost};
+    return levels;
+}
+
+void GridView::updateTerrainView()
+{
+    TRACE_SCOPE("terrain overlay", "view");
+    const std::vector<uint8_t>& levels = terrainLevels();
+    std::vector<QList<QPointF>> cells(terrainElements.size());
+    for (int idx = 0; idx < widthGrid * heightGrid; ++idx) {
+        const Node& node = gridNodes.Nodes[idx];
+        if (node.obstacle || node.cost == 1) continue;
+        auto level = std::find(levels.begin() + 1, levels.end(), node.cost);
+        if (level != levels.end())
+            cells[level - levels.begin() - 1].append(QPointF(node.xCoord, node.yCoord));
+    }
+    for (size_t i = 0; i < terrainElements.size(); ++i)
+        terrainElements[i]->replace(cells[i]);
+}
+
+void GridView::showFlowField(const FlowField& field)
+{
+    TRACE_SCOPE("flow field overlay", "view");
+    std::vector<QList<QPointF>> arrows(flowElements.size());
+    for (int idx = 0; idx < widthGrid * heightGrid; ++idx) {
+        if (gridNodes.Nodes[idx].obstacle) continue;
+        FLOWDIRECTIONS dir = field.directionAt(idx);
+        if (dir != FLOW_NONE)
+            arrows[dir].append(QPointF(idx % widthGrid + 1, idx / widthGrid + 1));
+    }
+    for (size_t dir = 0; dir < flowElements.size(); ++dir)
+        flowElements[dir]->replace(arrows[dir]);
+}
+
+void GridView::clearFlowField()
+{
+    for (QScatterSeries* arrows : flowElements)
+        arrows->clear();
 }
 
 void GridView::handleClickedPoint(const QPointF& point)
 {
+    TRACE_SCOPE("clicked point", "view");
     QPointF clickedPoint = point;
     QPointF nullPoint;
     int idx = coordToIndex(clickedPoint, widthGrid);
@@ -296,6 +402,20 @@ void GridView::handleClickedPoint(const QPointF& point)
             obstacleElements->replace(clickedPoint, nullPoint);
             gridNodes.Nodes[idx].obstacle = false;
         }
+        emit cellObstacleChanged(idx, gridNodes.Nodes[idx].obstacle);
+        updateTerrainView();
+    }
+    else if (currentInteraction == TERRAIN)
+    {
+        if (!gridNodes.Nodes[idx].obstacle)
+        {
+            // Next level up, back to 1 after the costliest
+            const std::vector<uint8_t>& levels = terrainLevels();
+            auto level = std::find(levels.begin(), levels.end(), gridNodes.Nodes[idx].cost);
+            gridNodes.Nodes[idx].cost = (level == levels.end() || level + 1 == levels.end()) ? levels.front() : *(level + 1);
+            emit cellCostChanged(idx, gridNodes.Nodes[idx].cost);
+            updateTerrainView();
+        }
     }
     else if (currentInteraction == START)
     {
@@ -322,6 +442,8 @@ void GridView::handleClickedPoint(const QPointF& point)
             obstacleElements->replace(idx, nullPoint);
             gridNodes.Nodes[prevStart].obstacle = true;
         }
+        emit cellObstacleChanged(prevStart, gridNodes.Nodes[prevStart].obstacle);
+        emit endpointMoved(START, idx);
     }
     else if (currentInteraction == END)
     {
@@ -348,6 +470,8 @@ void GridView::handleClickedPoint(const QPointF& point)
             obstacleElements->replace(idx, nullPoint);
             gridNodes.Nodes[prevEnd].obstacle = true;
         }
+        emit cellObstacleChanged(prevEnd, gridNodes.Nodes[prevEnd].obstacle);
+        emit endpointMoved(END, idx);
     }
     else if (currentInteraction == NOINTERACTION)
     {
@@ -425,8 +549,15 @@ void GridView::AlgorithmView(bool on)
     }
 }
 
+void GridView::paintEvent(QPaintEvent* event)
+{
+    TRACE_SCOPE("paint", "render");
+    QChartView::paintEvent(event);
+}
+
 bool GridView::handleUpdatedScatterGridView(UPDATETYPES type, int idx)
 {
+    TRACE_SCOPE("scatter update", "view");
     switch (type) {
     case VISIT:         replaceNextbyVisited(idx); break;
     case NEXT:          replaceFreebyNext(idx);    break;
@@ -441,6 +572,7 @@ bool GridView::handleUpdatedScatterGridView(UPDATETYPES type, int idx)
 
 bool GridView::handleUpdatedLineGridView(QPointF p, bool add, bool clear)
 {
+    TRACE_SCOPE("line update", "view");
     if (clear) pathLine->clear();
     updateLine(p, add);
     return true;
@@ -520,59 +652,3 @@ void GridView::updateLine(QPointF p, bool adding)
 }
 
 int GridView::getPathLength() const { return 0; }
-
-float GridView::calculateWallDensity() const
-{
-    int total = widthGrid * heightGrid;
-    if (total == 0) return 0;
-    int walls = 0;
-    for (const Node& n : gridNodes.Nodes)
-        if (n.obstacle) walls++;
-    return static_cast<float>(walls) / total;
-}
-
-int GridView::countDeadEnds() const
-{
-    int dead = 0;
-    for (const Node& n : gridNodes.Nodes) {
-        if (n.obstacle) continue;
-        int wallCount = 0;
-        int dx[] = {0,0,1,-1};
-        int dy[] = {1,-1,0,0};
-        for (int i=0; i<4; ++i) {
-            int nx = n.xCoord + dx[i];
-            int ny = n.yCoord + dy[i];
-            if (nx < 1 || nx > widthGrid || ny < 1 || ny > heightGrid) {
-                wallCount++;
-            } else {
-                int idx = coordToIndex(nx, ny, widthGrid);
-                if (gridNodes.Nodes[idx].obstacle) wallCount++;
-            }
-        }
-        if (wallCount == 3) dead++;
-    }
-    return dead;
-}
-
-float GridView::calculateBranchingFactor() const
-{
-    int totalNeighbors = 0;
-    int nonWall = 0;
-    for (const Node& n : gridNodes.Nodes) {
-        if (n.obstacle) continue;
-        nonWall++;
-        int cnt = 0;
-        int dx[] = {0,0,1,-1};
-        int dy[] = {1,-1,0,0};
-        for (int i=0; i<4; ++i) {
-            int nx = n.xCoord + dx[i];
-            int ny = n.yCoord + dy[i];
-            if (nx >=1 && nx<=widthGrid && ny>=1 && ny<=heightGrid) {
-                int idx = coordToIndex(nx, ny, widthGrid);
-                if (!gridNodes.Nodes[idx].obstacle) cnt++;
-            }
-        }
-        totalNeighbors += cnt;
-    }
-    return nonWall ? static_cast<float>(totalNeighbors) / nonWall : 0;
-}
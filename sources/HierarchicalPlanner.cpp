@@ -0,0 +1,624 @@
+#include "HierarchicalPlanner.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <sstream>
+#include <set>
+
+HierarchicalPlanner::HierarchicalPlanner(const HierarchyConfig& hierarchyConfig)
+    : config(hierarchyConfig), prepared(false), levels(1)
+{
+    config.clusterSize = std::max(2, config.clusterSize);
+    config.levelFactor = std::max(2, config.levelFactor);
+}
+
+std::string HierarchicalPlanner::name() const { return "HPA*"; }
+bool HierarchicalPlanner::isPrepared() const { return prepared; }
+int HierarchicalPlanner::levelCount() const { return levels; }
+int HierarchicalPlanner::nodeCount() const { return static_cast<int>(cellNode.size()); }
+
+void HierarchicalPlanner::clear()
+{
+    prepared = false;
+    snapshot = GridSnapshot();
+    nodes.clear();
+    freeNodes.clear();
+    cellNode.clear();
+    clusterNodes.clear();
+    borderNodes.clear();
+    intra.clear();
+}
+
+// -----------------------------------------------------------------
+// Cluster geometry
+// -----------------------------------------------------------------
+int HierarchicalPlanner::clusterSizeAt(int level) const
+{
+    int size = config.clusterSize;
+    for (int l = 1; l < level; ++l)
+        size *= config.levelFactor;
+    return size;
+}
+
+int HierarchicalPlanner::clustersXAt(int level) const
+{
+    int size = clusterSizeAt(level);
+    return (snapshot.width + size - 1) / size;
+}
+
+int HierarchicalPlanner::clustersYAt(int level) const
+{
+    int size = clusterSizeAt(level);
+    return (snapshot.height + size - 1) / size;
+}
+
+int HierarchicalPlanner::clusterOf(int cell, int level) const
+{
+    int size = clusterSizeAt(level);
+    return (cell % snapshot.width) / size + (cell / snapshot.width) / size * clustersXAt(level);
+}
+
+HierarchicalPlanner::Rect HierarchicalPlanner::clusterRect(int cluster, int level) const
+{
+    int size = clusterSizeAt(level);
+    int cx = cluster % clustersXAt(level);
+    int cy = cluster / clustersXAt(level);
+    Rect rect;
+    rect.x0 = cx * size;
+    rect.y0 = cy * size;
+    rect.x1 = std::min(snapshot.width, rect.x0 + size);
+    rect.y1 = std::min(snapshot.height, rect.y0 + size);
+    return rect;
+}
+
+int HierarchicalPlanner::crossingLevel(int cellA, int cellB) const
+{
+    for (int level = levels; level >= 1; --level) {
+        if (clusterOf(cellA, level) != clusterOf(cellB, level)) return level;
+    }
+    return 0;
+}
+
+// -----------------------------------------------------------------
+// Abstraction
+// -----------------------------------------------------------------
+int HierarchicalPlanner::acquireNode(int cell, int border)
+{
+    int id;
+    auto found = cellNode.find(cell);
+    if (found != cellNode.end()) {
+        id = found->second;
+    } else {
+        if (!freeNodes.empty()) {
+            id = freeNodes.back();
+            freeNodes.pop_back();
+        } else {
+            id = static_cast<int>(nodes.size());
+            nodes.push_back(AbstractNode());
+            for (auto& levelEdges : intra)
+                levelEdges.resize(nodes.size());
+        }
+        nodes[id].cell = cell;
+        nodes[id].level = 1;
+        nodes[id].refs = 0;
+        nodes[id].inter.clear();
+        cellNode[cell] = id;
+        clusterNodes[clusterOf(cell, 1)].push_back(id);
+    }
+    nodes[id].refs++;
+    borderNodes[border].push_back(id);
+    return id;
+}
+
+void HierarchicalPlanner::releaseBorder(int border)
+{
+    for (int id : borderNodes[border]) {
+        AbstractNode& node = nodes[id];
+        node.inter.erase(std::remove_if(node.inter.begin(), node.inter.end(),
+                                        [border](const Edge& e) { return e.border == border; }),
+                         node.inter.end());
+        if (--node.refs > 0) continue;
+
+        std::vector<int>& members = clusterNodes[clusterOf(node.cell, 1)];
+        members.erase(std::remove(members.begin(), members.end(), id), members.end());
+        cellNode.erase(node.cell);
+        for (auto& levelEdges : intra)
+            levelEdges[id].clear();
+        node.level = 0;
+        freeNodes.push_back(id);
+    }
+    borderNodes[border].clear();
+}
+
+// side 0: border with the east neighbour, side 1: border with the north neighbour
+void HierarchicalPlanner::buildBorder(int cluster, int side)
+{
+    const int w = snapshot.width;
+    const int size = config.clusterSize;
+    const int cx = cluster % clustersXAt(1);
+    const int cy = cluster / clustersXAt(1);
+    const int border = cluster * 2 + side;
+
+    int begin, end, fixed;
+    if (side == 0) {
+        if (cx + 1 >= clustersXAt(1)) return;
+        fixed = (cx + 1) * size - 1;
+        begin = cy * size;
+        end = std::min(snapshot.height, begin + size);
+    } else {
+        if (cy + 1 >= clustersYAt(1)) return;
+        fixed = (cy + 1) * size - 1;
+        begin = cx * size;
+        end = std::min(w, begin + size);
+    }
+
+    auto cellsAt = [&](int along, int& inside, int& outside) {
+        if (side == 0) {
+            inside = along * w + fixed;
+            outside = inside + 1;
+        } else {
+            inside = fixed * w + along;
+            outside = inside + w;
+        }
+    };
+
+    auto addTransition = [&](int along) {
+        int inside, outside;
+        cellsAt(along, inside, outside);
+        int a = acquireNode(inside, border);
+        int b = acquireNode(outside, border);
+        nodes[a].inter.push_back({b, 1.0f, border});
+        nodes[b].inter.push_back({a, 1.0f, border});
+    };
+
+    // Each maximal run of cells open on both sides is one entrance: short
+    // entrances get one transition in the middle, long ones one at each end
+    int runStart = -1;
+    for (int along = begin; along <= end; ++along) {
+        bool open = false;
+        if (along < end) {
+            int inside, outside;
+            cellsAt(along, inside, outside);
+            open = !snapshot.obstacle[inside] && !snapshot.obstacle[outside];
+        }
+        if (open && runStart == -1) {
+            runStart = along;
+        } else if (!open && runStart != -1) {
+            int length = along - runStart;
+            if (length < 6) {
+                addTransition(runStart + length / 2);
+            } else {
+                addTransition(runStart);
+                addTransition(along - 1);
+            }
+            runStart = -1;
+        }
+    }
+}
+
+void HierarchicalPlanner::updateNodeLevel(int id)
+{
+    AbstractNode& node = nodes[id];
+    node.level = 1;
+    for (const Edge& e : node.inter)
+        node.level = std::max(node.level, crossingLevel(node.cell, nodes[e.target].cell));
+}
+
+void HierarchicalPlanner::rectBfs(const Rect& rect, int source, std::vector<int>& dist, std::vector<int>& parent,
+                                  std::vector<int>& queue) const
+{
+    const int w = snapshot.width;
+    const int rw = rect.x1 - rect.x0;
+    const int area = rw * (rect.y1 - rect.y0);
+    dist.assign(area, -1);
+    parent.assign(area, -1);
+
+    auto local = [&](int cell) { return (cell / w - rect.y0) * rw + (cell % w - rect.x0); };
+
+    queue.clear();
+    queue.reserve(area);
+    queue.push_back(source);
+    dist[local(source)] = 0;
+
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int cell = queue[head];
+        int x = cell % w;
+        int y = cell / w;
+        int d = dist[local(cell)];
+
+        int nbs[4];
+        int count = 0;
+        if (x + 1 < rect.x1)  nbs[count++] = cell + 1;
+        if (y - 1 >= rect.y0) nbs[count++] = cell - w;
+        if (x - 1 >= rect.x0) nbs[count++] = cell - 1;
+        if (y + 1 < rect.y1)  nbs[count++] = cell + w;
+
+        for (int i = 0; i < count; ++i) {
+            int nb = nbs[i];
+            int li = local(nb);
+            if (snapshot.obstacle[nb] || dist[li] != -1) continue;
+            dist[li] = d + 1;
+            parent[li] = cell;
+            queue.push_back(nb);
+        }
+    }
+}
+
+void HierarchicalPlanner::buildIntraLevel1(int cluster)
+{
+    const Rect rect = clusterRect(cluster, 1);
+    const int w = snapshot.width;
+    const int rw = rect.x1 - rect.x0;
+    std::vector<int> dist, parent, queue;
+
+    for (int id : clusterNodes[cluster]) {
+        std::vector<Edge>& edges = intra[0][id];
+        edges.clear();
+        rectBfs(rect, nodes[id].cell, dist, parent, queue);
+        for (int other : clusterNodes[cluster]) {
+            int cell = nodes[other].cell;
+            int d = dist[(cell / w - rect.y0) * rw + (cell % w - rect.x0)];
+            if (other != id && d >= 0) edges.push_back({other, static_cast<float>(d), -1});
+        }
+    }
+}
+
+void HierarchicalPlanner::nodesInCluster(int level, int cluster, int minLevel, std::vector<int>& out) const
+{
+    const Rect rect = clusterRect(cluster, level);
+    const int size = config.clusterSize;
+    out.clear();
+    for (int cy = rect.y0 / size; cy * size < rect.y1; ++cy) {
+        for (int cx = rect.x0 / size; cx * size < rect.x1; ++cx) {
+            for (int id : clusterNodes[cy * clustersXAt(1) + cx]) {
+                if (nodes[id].level >= minLevel) out.push_back(id);
+            }
+        }
+    }
+}
+
+void HierarchicalPlanner::clusterDijkstra(int level, int cluster, int source, std::unordered_map<int, float>& dist,
+                                          std::unordered_map<int, std::pair<int, int>>* parent) const
+{
+    typedef std::pair<float, int> Entry;
+    std::vector<Entry> open;
+    auto heapCmp = std::greater<Entry>();
+
+    dist.clear();
+    dist[source] = 0.0f;
+    open.push_back({0.0f, source});
+
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), heapCmp);
+        Entry top = open.back();
+        open.pop_back();
+        int u = top.second;
+        if (top.first > dist[u]) continue;
+
+        auto relax = [&](int v, float cost, int kind) {
+            float nd = top.first + cost;
+            auto it = dist.find(v);
+            if (it != dist.end() && it->second <= nd) return;
+            dist[v] = nd;
+            if (parent) (*parent)[v] = {u, kind};
+            open.push_back({nd, v});
+            std::push_heap(open.begin(), open.end(), heapCmp);
+        };
+
+        for (const Edge& e : intra[level - 2][u])
+            relax(e.target, e.cost, level - 1);
+        for (const Edge& e : nodes[u].inter) {
+            const AbstractNode& target = nodes[e.target];
+            if (target.level >= level - 1 && clusterOf(target.cell, level) == cluster)
+                relax(e.target, e.cost, INTER_EDGE);
+        }
+    }
+}
+
+void HierarchicalPlanner::buildIntraLevel(int level, int cluster)
+{
+    std::vector<int> members;
+    nodesInCluster(level, cluster, level, members);
+    std::unordered_map<int, float> dist;
+
+    for (int id : members) {
+        std::vector<Edge>& edges = intra[level - 1][id];
+        edges.clear();
+        clusterDijkstra(level, cluster, id, dist, nullptr);
+        for (int other : members) {
+            auto it = dist.find(other);
+            if (other != id && it != dist.end()) edges.push_back({other, it->second, -1});
+        }
+    }
+}
+
+void HierarchicalPlanner::prepare(const GridSnapshot& newSnapshot)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    clear();
+    snapshot = newSnapshot;
+
+    levels = config.levels;
+    if (levels <= 0) {
+        levels = 1;
+        while (levels < 8 && static_cast<long long>(clustersXAt(levels)) * clustersYAt(levels) > 1024)
+            levels++;
+    }
+
+    const int clusters = clustersXAt(1) * clustersYAt(1);
+    clusterNodes.assign(clusters, std::vector<int>());
+    borderNodes.assign(clusters * 2, std::vector<int>());
+    intra.assign(levels, std::vector<std::vector<Edge>>());
+
+    for (int cluster = 0; cluster < clusters; ++cluster) {
+        buildBorder(cluster, 0);
+        buildBorder(cluster, 1);
+    }
+    for (const auto& entry : cellNode)
+        updateNodeLevel(entry.second);
+    for (int cluster = 0; cluster < clusters; ++cluster)
+        buildIntraLevel1(cluster);
+    for (int level = 2; level <= levels; ++level) {
+        for (int cluster = 0; cluster < clustersXAt(level) * clustersYAt(level); ++cluster)
+            buildIntraLevel(level, cluster);
+    }
+
+    prepared = true;
+    lastPrepareNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - t0).count();
+}
+
+void HierarchicalPlanner::setObstacle(int index, bool obstacle)
+{
+    if (!prepared || snapshot.obstacle[index] == (obstacle ? 1 : 0)) return;
+    snapshot.obstacle[index] = obstacle ? 1 : 0;
+    snapshot.markEdited();
+
+    const int w = snapshot.width;
+    const int cluster = clusterOf(index, 1);
+    const Rect rect = clusterRect(cluster, 1);
+    const int x = index % w;
+    const int y = index / w;
+
+    // Borders only change when the cell lies on one of them
+    std::vector<int> affected = {cluster};
+    auto rebuildBorder = [&](int owner, int side, int neighbour) {
+        releaseBorder(owner * 2 + side);
+        buildBorder(owner, side);
+        affected.push_back(neighbour);
+    };
+    if (x == rect.x1 - 1 && rect.x1 < w)               rebuildBorder(cluster, 0, cluster + 1);
+    if (y == rect.y1 - 1 && rect.y1 < snapshot.height) rebuildBorder(cluster, 1, cluster + clustersXAt(1));
+    if (x == rect.x0 && rect.x0 > 0)                   rebuildBorder(cluster - 1, 0, cluster - 1);
+    if (y == rect.y0 && rect.y0 > 0)                   rebuildBorder(cluster - clustersXAt(1), 1, cluster - clustersXAt(1));
+
+    for (int c : affected) {
+        for (int id : clusterNodes[c])
+            updateNodeLevel(id);
+    }
+    for (int c : affected)
+        buildIntraLevel1(c);
+
+    for (int level = 2; level <= levels; ++level) {
+        std::set<int> parents;
+        for (int c : affected) {
+            Rect r = clusterRect(c, 1);
+            parents.insert(clusterOf(r.y0 * w + r.x0, level));
+        }
+        for (int c : parents)
+            buildIntraLevel(level, c);
+    }
+}
+
+// -----------------------------------------------------------------
+// Query
+// -----------------------------------------------------------------
+int HierarchicalPlanner::usageLevel(int node, int startCell, int goalCell) const
+{
+    const int cell = nodes[node].cell;
+    for (int level = std::min(nodes[node].level, levels); level >= 2; --level) {
+        int cluster = clusterOf(cell, level);
+        if (cluster != clusterOf(startCell, level) && cluster != clusterOf(goalCell, level))
+            return level;
+    }
+    return 1;
+}
+
+void HierarchicalPlanner::appendRectPath(const Rect& rect, int from, int to, SearchScratch& scratch,
+                                         std::vector<int>& cells) const
+{
+    const int w = snapshot.width;
+    const int rw = rect.x1 - rect.x0;
+    std::vector<int>& parent = scratch.regionParent;
+    rectBfs(rect, from, scratch.regionDistance, parent, scratch.regionQueue);
+
+    size_t first = cells.size();
+    for (int cell = to; cell != from && cell != -1; cell = parent[(cell / w - rect.y0) * rw + (cell % w - rect.x0)])
+        cells.push_back(cell);
+    std::reverse(cells.begin() + first, cells.end());
+}
+
+void HierarchicalPlanner::appendRefinedEdge(int fromNode, int toNode, int kind, SearchScratch& scratch,
+                                            std::vector<int>& cells) const
+{
+    const int fromCell = nodes[fromNode].cell;
+    const int toCell = nodes[toNode].cell;
+
+    if (kind == INTER_EDGE) {
+        cells.push_back(toCell);
+    } else if (kind == 1) {
+        appendRectPath(clusterRect(clusterOf(fromCell, 1), 1), fromCell, toCell, scratch, cells);
+    } else {
+        // Expand one level down inside the cluster both nodes share
+        const int cluster = clusterOf(fromCell, kind);
+        std::unordered_map<int, float> dist;
+        std::unordered_map<int, std::pair<int, int>> parent;
+        clusterDijkstra(kind, cluster, fromNode, dist, &parent);
+
+        std::vector<std::pair<int, int>> steps;
+        for (int node = toNode; node != fromNode; node = parent[node].first)
+            steps.push_back({node, parent[node].second});
+        int prev = fromNode;
+        for (auto it = steps.rbegin(); it != steps.rend(); ++it) {
+            appendRefinedEdge(prev, it->first, it->second, scratch, cells);
+            prev = it->first;
+        }
+    }
+}
+
+SearchResult HierarchicalPlanner::query(int start, int goal, SearchScratch& scratch) const
+{
+    auto t0 = std::chrono::steady_clock::now();
+    SearchResult result;
+    auto finish = [&]() {
+        result.memoryBytes = scratch.memoryBytes() + memoryBytes();
+        result.timeElapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now() - t0).count();
+        // Moved out, a copy would allocate the path again
+        return std::move(result);
+    };
+    if (!prepared) return finish();
+    if (start == goal) {
+        // The one-cell path, as the other solvers give it
+        scratch.takePath(result.path);
+        result.path.assign(1, start);
+        result.nodesVisited = 1;
+        return finish();
+    }
+    if (snapshot.obstacle[goal]) return finish();
+
+    const int w = snapshot.width;
+    const int nodeTotal = static_cast<int>(nodes.size());
+    const int S = nodeTotal;
+    const int G = nodeTotal + 1;
+    const int goalCluster = clusterOf(goal, 1);
+    const Rect goalRect = clusterRect(goalCluster, 1);
+
+    auto local = [w](const Rect& r, int cell) { return (cell / w - r.y0) * (r.x1 - r.x0) + (cell % w - r.x0); };
+
+    auto cellOf = [&](int node) { return node == S ? start : node == G ? goal : nodes[node].cell; };
+    auto heuristic = [&](int node) {
+        int cell = cellOf(node);
+        return static_cast<float>(std::abs(cell % w - goal % w) + std::abs(cell / w - goal / w));
+    };
+
+    // A* over the abstract graph; kind[] remembers how each node was reached
+    scratch.prepare(nodeTotal + 2);
+    std::vector<int>& kind = scratch.stamps;
+    kind.assign(nodeTotal + 2, LOCAL_EDGE);
+    auto heapCmp = std::greater<std::pair<float, int>>();
+    int u = S;
+    auto relax = [&](int v, float cost, int edgeKind) {
+        float newCost = scratch.distance[u] + cost;
+        if (newCost >= scratch.distance[v]) return;
+        scratch.distance[v] = newCost;
+        scratch.parent[v] = u;
+        kind[v] = edgeKind;
+        scratch.open.push_back({newCost + heuristic(v), v});
+        std::push_heap(scratch.open.begin(), scratch.open.end(), heapCmp);
+    };
+
+    // Expand the start: connect it to the abstract nodes of its cluster. A
+    // start on an obstacle leaves through its free neighbours, as in
+    // dijkstraSearch. Edges out of the start keep their gate's slot in kind[].
+    int gates[4];
+    int gateCount = 0;
+    if (!snapshot.obstacle[start]) {
+        gates[gateCount++] = start;
+    } else {
+        const int x = start % w;
+        const int y = start / w;
+        if (x + 1 < w && !snapshot.obstacle[start + 1])               gates[gateCount++] = start + 1;
+        if (y - 1 >= 0 && !snapshot.obstacle[start - w])              gates[gateCount++] = start - w;
+        if (x - 1 >= 0 && !snapshot.obstacle[start - 1])              gates[gateCount++] = start - 1;
+        if (y + 1 < snapshot.height && !snapshot.obstacle[start + w]) gates[gateCount++] = start + w;
+    }
+
+    std::vector<int>& dist = scratch.regionDistance;
+    scratch.distance[S] = 0.0f;
+    scratch.closed[S] = 1;
+    result.nodesVisited++;
+    for (int slot = 0; slot < gateCount; ++slot) {
+        const int gate = gates[slot];
+        const int cluster = clusterOf(gate, 1);
+        const Rect rect = clusterRect(cluster, 1);
+        const float offset = gate == start ? 0.0f : 1.0f;
+        rectBfs(rect, gate, dist, scratch.regionParent, scratch.regionQueue);
+        for (int id : clusterNodes[cluster]) {
+            int d = dist[local(rect, nodes[id].cell)];
+            if (d >= 0) relax(id, d + offset, slot);
+        }
+        if (cluster == goalCluster && dist[local(rect, goal)] >= 0)
+            relax(G, dist[local(rect, goal)] + offset, slot);
+    }
+
+    // Distances to the goal inside its cluster, read while the search runs
+    rectBfs(goalRect, goal, dist, scratch.regionParent, scratch.regionQueue);
+
+    while (!scratch.open.empty()) {
+        std::pop_heap(scratch.open.begin(), scratch.open.end(), heapCmp);
+        u = scratch.open.back().second;
+        scratch.open.pop_back();
+        if (scratch.closed[u]) continue;
+        scratch.closed[u] = 1;
+        result.nodesVisited++;
+        if (u == G) break;
+
+        int level = usageLevel(u, start, goal);
+        for (const Edge& e : intra[level - 1][u])
+            relax(e.target, e.cost, level);
+        for (const Edge& e : nodes[u].inter)
+            relax(e.target, e.cost, INTER_EDGE);
+        if (level == 1 && clusterOf(nodes[u].cell, 1) == goalCluster) {
+            int d = dist[local(goalRect, nodes[u].cell)];
+            if (d >= 0) relax(G, static_cast<float>(d), LOCAL_EDGE);
+        }
+    }
+
+    if (!std::isfinite(scratch.distance[G])) return finish();
+
+    // Refine the abstract path back into cells
+    std::vector<int>& chain = scratch.cells;
+    tracePath(scratch.parent, G, chain);
+
+    scratch.takePath(result.path);
+    result.path.push_back(start);
+    for (size_t i = 1; i < chain.size(); ++i) {
+        int from = chain[i - 1];
+        int to = chain[i];
+        if (from == S) {
+            int gate = gates[kind[to]];
+            if (gate != start) result.path.push_back(gate);
+            appendRectPath(clusterRect(clusterOf(gate, 1), 1), gate, cellOf(to), scratch, result.path);
+        } else if (kind[to] == LOCAL_EDGE) {
+            appendRectPath(goalRect, cellOf(from), goal, scratch, result.path);
+        } else {
+            appendRefinedEdge(from, to, kind[to], scratch, result.path);
+        }
+    }
+    result.pathLength = static_cast<int>(result.path.size()) - 1;
+    result.pathCost = scratch.distance[G];
+    return finish();
+}
+
+size_t HierarchicalPlanner::memoryBytes() const
+{
+    size_t bytes = snapshot.obstacle.capacity() + nodes.capacity() * sizeof(AbstractNode)
+                 + cellNode.size() * 2 * sizeof(int);
+    for (const AbstractNode& node : nodes)
+        bytes += node.inter.capacity() * sizeof(Edge);
+    for (const auto& levelEdges : intra) {
+        for (const auto& edges : levelEdges)
+            bytes += edges.capacity() * sizeof(Edge) + sizeof(edges);
+    }
+    return bytes;
+}
+
+std::string HierarchicalPlanner::statistics() const
+{
+    std::ostringstream text;
+    text << levels << " level(s), " << nodeCount() << " abstract nodes";
+    return text.str();
+}
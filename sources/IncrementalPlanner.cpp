@@ -0,0 +1,255 @@
+#include "IncrementalPlanner.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+IncrementalPlanner::IncrementalPlanner() : initialised(false), needsFullReset(false) {}
+
+bool IncrementalPlanner::isInitialised() const { return initialised; }
+const GridSnapshot& IncrementalPlanner::getSnapshot() const { return snapshot; }
+
+void IncrementalPlanner::clear()
+{
+    initialised = false;
+    g.clear();
+    rhs.clear();
+    heapPos.clear();
+    heap.clear();
+}
+
+void IncrementalPlanner::reset(const GridSnapshot& newSnapshot)
+{
+    snapshot = newSnapshot;
+    const int cells = snapshot.cellCount();
+    g.assign(cells, INFINITY);
+    rhs.assign(cells, INFINITY);
+    heapPos.assign(cells, -1);
+    heap.clear();
+
+    rhs[snapshot.startIndex] = 0.0f;
+    heapPush(snapshot.startIndex, calculateKey(snapshot.startIndex));
+    initialised = true;
+    needsFullReset = false;
+}
+
+float IncrementalPlanner::heuristic(int cell) const
+{
+    const int w = snapshot.width;
+    return static_cast<float>(std::abs(cell % w - snapshot.endIndex % w)
+                              + std::abs(cell / w - snapshot.endIndex / w));
+}
+
+IncrementalPlanner::Key IncrementalPlanner::calculateKey(int cell) const
+{
+    float best = std::min(g[cell], rhs[cell]);
+    return Key(best + heuristic(cell), best);
+}
+
+int IncrementalPlanner::neighbours(int cell, int* out) const
+{
+    const int w = snapshot.width;
+    const int x = cell % w;
+    const int y = cell / w;
+    int count = 0;
+    if (x + 1 < w)               out[count++] = cell + 1;
+    if (y - 1 >= 0)              out[count++] = cell - w;
+    if (x - 1 >= 0)              out[count++] = cell - 1;
+    if (y + 1 < snapshot.height) out[count++] = cell + w;
+    return count;
+}
+
+void IncrementalPlanner::updateVertex(int cell)
+{
+    if (cell != snapshot.startIndex) {
+        float best = INFINITY;
+        if (!snapshot.obstacle[cell]) {
+            int nbs[4];
+            int count = neighbours(cell, nbs);
+            for (int i = 0; i < count; ++i)
+                best = std::min(best, g[nbs[i]]);
+            // Every edge into the cell costs what entering it costs
+            best += snapshot.costAt(cell);
+        }
+        rhs[cell] = best;
+    }
+
+    if (g[cell] != rhs[cell]) {
+        if (heapPos[cell] == -1) heapPush(cell, calculateKey(cell));
+        else                     heapUpdate(cell, calculateKey(cell));
+    } else if (heapPos[cell] != -1) {
+        heapRemove(cell);
+    }
+}
+
+void IncrementalPlanner::setObstacle(int index, bool obstacle)
+{
+    if (!initialised || snapshot.obstacle[index] == (obstacle ? 1 : 0)) return;
+    snapshot.obstacle[index] = obstacle ? 1 : 0;
+    snapshot.markEdited();
+    // Only the edge costs into the flipped cell change
+    updateVertex(index);
+}
+
+void IncrementalPlanner::setCost(int index, int cost)
+{
+    if (!initialised || snapshot.costAt(index) == cost) return;
+    if (snapshot.cost.empty()) snapshot.cost.assign(snapshot.cellCount(), 1);
+    snapshot.cost[index] = static_cast<uint8_t>(cost);
+    snapshot.markEdited();
+    // Same as an obstacle flip: only the edges into the cell change
+    updateVertex(index);
+}
+
+void IncrementalPlanner::setGoal(int index)
+{
+    if (!initialised || index == snapshot.endIndex) return;
+    snapshot.endIndex = index;
+    // g/rhs stay valid, only the heuristic part of the queued keys moved
+    rebuildQueueKeys();
+}
+
+void IncrementalPlanner::setStart(int index)
+{
+    if (!initialised || index == snapshot.startIndex) return;
+    snapshot.startIndex = index;
+    needsFullReset = true;
+}
+
+void IncrementalPlanner::rebuildQueueKeys()
+{
+    for (auto& entry : heap)
+        entry.first = calculateKey(entry.second);
+    for (int pos = static_cast<int>(heap.size()) / 2 - 1; pos >= 0; --pos)
+        siftDown(pos);
+}
+
+SearchResult IncrementalPlanner::computePath()
+{
+    auto t0 = std::chrono::steady_clock::now();
+    SearchResult result;
+    if (!initialised) return result;
+    if (needsFullReset) reset(snapshot);
+
+    const int goal = snapshot.endIndex;
+    int nbs[4];
+
+    while (!heap.empty() && (heap.front().first < calculateKey(goal) || rhs[goal] != g[goal])) {
+        int cell = heapPop();
+        result.nodesVisited++;
+
+        if (g[cell] > rhs[cell]) {
+            g[cell] = rhs[cell];
+        } else {
+            g[cell] = INFINITY;
+            updateVertex(cell);
+        }
+        int count = neighbours(cell, nbs);
+        for (int i = 0; i < count; ++i)
+            updateVertex(nbs[i]);
+    }
+
+    // Walk back from the goal along decreasing g values; a goal on the start
+    // is the one-cell path, as the other solvers give it
+    if (goal == snapshot.startIndex) {
+        result.path.push_back(goal);
+    } else if (std::isfinite(g[goal])) {
+        int cell = goal;
+        result.path.push_back(cell);
+        while (cell != snapshot.startIndex) {
+            int count = neighbours(cell, nbs);
+            const float enter = snapshot.costAt(cell);
+            int next = -1;
+            for (int i = 0; i < count; ++i) {
+                if (g[nbs[i]] + enter == g[cell]) {
+                    next = nbs[i];
+                    break;
+                }
+            }
+            if (next == -1) break;
+            cell = next;
+            result.path.push_back(cell);
+        }
+        std::reverse(result.path.begin(), result.path.end());
+        result.pathLength = static_cast<int>(result.path.size()) - 1;
+        result.pathCost = g[goal];
+    }
+
+    result.memoryBytes = (g.capacity() + rhs.capacity()) * sizeof(float)
+                       + heapPos.capacity() * sizeof(int)
+                       + heap.capacity() * sizeof(std::pair<Key, int>)
+                       + snapshot.obstacle.capacity() + snapshot.cost.capacity();
+    result.timeElapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now() - t0).count();
+    return result;
+}
+
+// -----------------------------------------------------------------
+// Indexed heap
+// -----------------------------------------------------------------
+void IncrementalPlanner::heapSwap(int a, int b)
+{
+    std::swap(heap[a], heap[b]);
+    heapPos[heap[a].second] = a;
+    heapPos[heap[b].second] = b;
+}
+
+void IncrementalPlanner::siftUp(int pos)
+{
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!(heap[pos].first < heap[parent].first)) break;
+        heapSwap(pos, parent);
+        pos = parent;
+    }
+}
+
+void IncrementalPlanner::siftDown(int pos)
+{
+    const int size = static_cast<int>(heap.size());
+    while (true) {
+        int smallest = pos;
+        int left = 2 * pos + 1;
+        int right = left + 1;
+        if (left < size && heap[left].first < heap[smallest].first) smallest = left;
+        if (right < size && heap[right].first < heap[smallest].first) smallest = right;
+        if (smallest == pos) break;
+        heapSwap(pos, smallest);
+        pos = smallest;
+    }
+}
+
+void IncrementalPlanner::heapPush(int cell, const Key& key)
+{
+    heap.push_back({key, cell});
+    heapPos[cell] = static_cast<int>(heap.size()) - 1;
+    siftUp(heapPos[cell]);
+}
+
+void IncrementalPlanner::heapUpdate(int cell, const Key& key)
+{
+    int pos = heapPos[cell];
+    heap[pos].first = key;
+    siftUp(pos);
+    siftDown(heapPos[cell]);
+}
+
+void IncrementalPlanner::heapRemove(int cell)
+{
+    int pos = heapPos[cell];
+    int last = static_cast<int>(heap.size()) - 1;
+    if (pos != last) heapSwap(pos, last);
+    heap.pop_back();
+    heapPos[cell] = -1;
+    if (pos < last) {
+        siftUp(pos);
+        siftDown(heapPos[heap[pos].second]);
+    }
+}
+
+int IncrementalPlanner::heapPop()
+{
+    int cell = heap.front().second;
+    heapRemove(cell);
+    return cell;
+}
@@ -0,0 +1,139 @@
+#include "JobExecutor.h"
+#include <algorithm>
+#include <chrono>
+
+double BatchReport::queriesPerSecond() const
+{
+    return wallNs > 0 ? jobCount * 1e9 / wallNs : 0.0;
+}
+
+double BatchReport::utilisation(int worker) const
+{
+    return wallNs > 0 ? static_cast<double>(workers[worker].busyNs) / wallNs : 0.0;
+}
+
+WorkStealingExecutor::WorkStealingExecutor(int threadCount, int chunk)
+{
+    threads = threadCount > 0 ? threadCount
+                              : std::max(1u, std::thread::hardware_concurrency());
+    chunkSize = std::max(1, chunk);
+}
+
+WorkStealingExecutor::~WorkStealingExecutor()
+{
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& t : pool)
+        t.join();
+}
+
+int WorkStealingExecutor::threadCount() const
+{
+    return threads;
+}
+
+bool WorkStealingExecutor::popLocal(int worker, Chunk& chunk)
+{
+    WorkerQueue& queue = queues[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.chunks.empty()) return false;
+    chunk = queue.chunks.back();
+    queue.chunks.pop_back();
+    return true;
+}
+
+bool WorkStealingExecutor::steal(int thief, Chunk& chunk)
+{
+    // Scan the other queues starting after the thief to spread contention
+    for (int offset = 1; offset < threads; ++offset) {
+        WorkerQueue& victim = queues[(thief + offset) % threads];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.chunks.empty()) continue;
+        chunk = victim.chunks.front();
+        victim.chunks.pop_front();
+        return true;
+    }
+    return false;
+}
+
+BatchReport WorkStealingExecutor::run(size_t jobCount, const std::function<void(size_t, int)>& task)
+{
+    BatchReport report;
+    report.jobCount = static_cast<long long>(jobCount);
+    report.workers.assign(threads, WorkerReport());
+
+    // Chunked submission, dealt round-robin so every deque starts with work
+    if (queues.size() != static_cast<size_t>(threads)) queues = std::vector<WorkerQueue>(threads);
+    int target = 0;
+    size_t chunkCount = 0;
+    for (size_t begin = 0; begin < jobCount; begin += chunkSize) {
+        queues[target].chunks.push_back({begin, std::min(jobCount, begin + chunkSize)});
+        target = (target + 1) % threads;
+        chunkCount++;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+
+    const std::function<void(int)> loop = [&](int worker) {
+        WorkerReport& stats = report.workers[worker];
+        Chunk chunk;
+        while (true) {
+            if (!popLocal(worker, chunk)) {
+                // Nothing is submitted after start, so empty everywhere means done
+                if (!steal(worker, chunk)) break;
+                stats.chunksStolen++;
+            }
+            auto busyStart = std::chrono::steady_clock::now();
+            for (size_t job = chunk.begin; job < chunk.end; ++job)
+                task(job, worker);
+            stats.busyNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now() - busyStart).count();
+            stats.jobsDone += static_cast<long long>(chunk.end - chunk.begin);
+        }
+    };
+
+    const int active = static_cast<int>(std::min<size_t>(threads, chunkCount));
+    if (active <= 1) {
+        loop(0);
+    } else {
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            for (int worker = static_cast<int>(pool.size()) + 1; worker < threads; ++worker)
+                pool.emplace_back(&WorkStealingExecutor::poolLoop, this, worker);
+            workerLoop = &loop;
+            activeWorkers = active;
+            runningWorkers = active - 1;
+            generation++;
+        }
+        wake.notify_all();
+        loop(0);
+        std::unique_lock<std::mutex> lock(poolMutex);
+        finished.wait(lock, [this] { return runningWorkers == 0; });
+        workerLoop = nullptr;
+    }
+
+    report.wallNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - t0).count();
+    return report;
+}
+
+void WorkStealingExecutor::poolLoop(int worker)
+{
+    unsigned long long seen = 0;
+    std::unique_lock<std::mutex> lock(poolMutex);
+    while (true) {
+        wake.wait(lock, [&] { return stopping || generation != seen; });
+        if (stopping) return;
+        seen = generation;
+        // Runs with fewer chunks than threads leave the last workers parked
+        if (worker >= activeWorkers) continue;
+        const std::function<void(int)>& loop = *workerLoop;
+        lock.unlock();
+        loop(worker);
+        lock.lock();
+        if (--runningWorkers == 0) finished.notify_one();
+    }
+}
@@ -0,0 +1,293 @@
+#include "LandmarkPlanner.h"
+#include "JobExecutor.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <sstream>
+#if defined(__SSE2__) || defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+unsigned long long obstacleChecksum(const GridSnapshot& snapshot)
+{
+    unsigned long long hash = 1469598103934665603ull;
+    auto mix = [&hash](unsigned long long value) {
+        hash ^= value;
+        hash *= 1099511628211ull;
+    };
+    mix(static_cast<unsigned long long>(snapshot.width));
+    mix(static_cast<unsigned long long>(snapshot.height));
+    for (uint8_t cell : snapshot.obstacle)
+        mix(cell);
+    return hash;
+}
+
+LandmarkPlanner::LandmarkPlanner(int count, int threadCount)
+    : landmarkCount(std::max(1, count)), threads(threadCount), prepared(false)
+{
+}
+
+std::string LandmarkPlanner::name() const { return "ALT"; }
+bool LandmarkPlanner::isPrepared() const { return prepared; }
+const LandmarkTable& LandmarkPlanner::landmarks() const { return table; }
+
+void LandmarkPlanner::clear()
+{
+    prepared = false;
+    snapshot = GridSnapshot();
+    table = LandmarkTable();
+}
+
+void LandmarkPlanner::setObstacle(int index, bool obstacle)
+{
+    if (!prepared) return;
+    if (obstacle) {
+        snapshot.obstacle[index] = 1;
+        snapshot.markEdited();
+    } else if (snapshot.obstacle[index]) {
+        clear();
+    }
+}
+
+// Unit-cost grid, so a BFS gives the same distances as Dijkstra
+void LandmarkPlanner::distancesFrom(int source, std::vector<int>& dist, std::vector<int>& queue) const
+{
+    const int w = snapshot.width;
+    const int h = snapshot.height;
+    dist.assign(snapshot.cellCount(), -1);
+    queue.clear();
+    dist[source] = 0;
+    queue.push_back(source);
+
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int cur = queue[head];
+        int x = cur % w;
+        int y = cur / w;
+        int nbs[4];
+        int count = 0;
+        if (x + 1 < w)  nbs[count++] = cur + 1;
+        if (y - 1 >= 0) nbs[count++] = cur - w;
+        if (x - 1 >= 0) nbs[count++] = cur - 1;
+        if (y + 1 < h)  nbs[count++] = cur + w;
+
+        for (int i = 0; i < count; ++i) {
+            int nb = nbs[i];
+            if (snapshot.obstacle[nb] || dist[nb] != -1) continue;
+            dist[nb] = dist[cur] + 1;
+            queue.push_back(nb);
+        }
+    }
+}
+
+// Farthest-point selection: each landmark is the cell farthest from all the
+// previous ones. minDist is maintained with a BFS from the new landmark that
+// stops wherever it cannot improve, so selection stays cheap. Only the region
+// around the first free cell is covered; other regions have no paths into it.
+void LandmarkPlanner::selectLandmarks(std::vector<int>& cells) const
+{
+    const int w = snapshot.width;
+    const int h = snapshot.height;
+    cells.clear();
+
+    int seed = 0;
+    while (seed < snapshot.cellCount() && snapshot.obstacle[seed])
+        seed++;
+    if (seed == snapshot.cellCount()) return;
+
+    std::vector<int> minDist, queue;
+    distancesFrom(seed, minDist, queue);
+    int first = queue.back();
+    distancesFrom(first, minDist, queue);
+    cells.push_back(first);
+
+    while (static_cast<int>(cells.size()) < landmarkCount) {
+        int next = static_cast<int>(std::max_element(minDist.begin(), minDist.end()) - minDist.begin());
+        if (minDist[next] <= 0) break;
+        cells.push_back(next);
+
+        minDist[next] = 0;
+        queue.clear();
+        queue.push_back(next);
+        for (size_t head = 0; head < queue.size(); ++head) {
+            int cur = queue[head];
+            int x = cur % w;
+            int y = cur / w;
+            int nbs[4];
+            int count = 0;
+            if (x + 1 < w)  nbs[count++] = cur + 1;
+            if (y - 1 >= 0) nbs[count++] = cur - w;
+            if (x - 1 >= 0) nbs[count++] = cur - 1;
+            if (y + 1 < h)  nbs[count++] = cur + w;
+
+            for (int i = 0; i < count; ++i) {
+                int nb = nbs[i];
+                if (snapshot.obstacle[nb] || minDist[cur] + 1 >= minDist[nb]) continue;
+                minDist[nb] = minDist[cur] + 1;
+                queue.push_back(nb);
+            }
+        }
+    }
+}
+
+void LandmarkPlanner::prepare(const GridSnapshot& newSnapshot)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    clear();
+    snapshot = newSnapshot;
+
+    selectLandmarks(table.cells);
+    table.count = static_cast<int>(table.cells.size());
+    table.stride = LandmarkTable::strideFor(table.count);
+    table.distance.assign(static_cast<size_t>(snapshot.cellCount()) * table.stride, 0.0f);
+
+    WorkStealingExecutor executor(threads, 1);
+    const int workers = executor.threadCount();
+
+    // One full search per landmark, each into its own column...
+    std::vector<std::vector<int>> columns(table.count);
+    std::vector<std::vector<int>> queues(workers);
+    executor.run(table.count, [&](size_t k, int worker) {
+        distancesFrom(table.cells[k], columns[k], queues[worker]);
+    });
+
+    // ...then the columns are interleaved into cell-major rows, in bands
+    const int cellCount = snapshot.cellCount();
+    executor.run(workers, [&](size_t band, int) {
+        int first = static_cast<int>(static_cast<long long>(cellCount) * band / workers);
+        int last = static_cast<int>(static_cast<long long>(cellCount) * (band + 1) / workers);
+        for (int cell = first; cell < last; ++cell) {
+            float* row = &table.distance[static_cast<size_t>(cell) * table.stride];
+            for (int k = 0; k < table.count; ++k)
+                row[k] = static_cast<float>(columns[k][cell]);
+        }
+    });
+
+    prepared = true;
+    lastPrepareNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - t0).count();
+}
+
+bool LandmarkPlanner::adopt(const GridSnapshot& newSnapshot, const LandmarkTable& stored)
+{
+    clear();
+    if (stored.stride != LandmarkTable::strideFor(stored.count)
+        || stored.distance.size() != static_cast<size_t>(newSnapshot.cellCount()) * stored.stride)
+        return false;
+
+    snapshot = newSnapshot;
+    table = stored;
+    prepared = true;
+    lastPrepareNs = 0;
+    return true;
+}
+
+// max_k |d(l_k, cell) - d(l_k, goal)|, a whole row per instruction
+float LandmarkPlanner::lowerBound(int cell, const float* goalRow) const
+{
+    const float* row = table.row(cell);
+#if defined(__AVX__)
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    __m256 best = _mm256_setzero_ps();
+    for (int k = 0; k < table.stride; k += 8) {
+        __m256 diff = _mm256_sub_ps(_mm256_loadu_ps(row + k), _mm256_loadu_ps(goalRow + k));
+        best = _mm256_max_ps(best, _mm256_andnot_ps(signMask, diff));
+    }
+    __m128 m = _mm_max_ps(_mm256_castps256_ps128(best), _mm256_extractf128_ps(best, 1));
+#elif defined(__SSE2__)
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    __m128 m = _mm_setzero_ps();
+    for (int k = 0; k < table.stride; k += 4) {
+        __m128 diff = _mm_sub_ps(_mm_loadu_ps(row + k), _mm_loadu_ps(goalRow + k));
+        m = _mm_max_ps(m, _mm_andnot_ps(signMask, diff));
+    }
+#else
+    float best = 0.0f;
+    for (int k = 0; k < table.count; ++k)
+        best = std::max(best, std::abs(row[k] - goalRow[k]));
+    return best;
+#endif
+#if defined(__SSE2__) || defined(__AVX__)
+    m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+    m = _mm_max_ss(m, _mm_shuffle_ps(m, m, 1));
+    return _mm_cvtss_f32(m);
+#endif
+}
+
+SearchResult LandmarkPlanner::query(int start, int goal, SearchScratch& scratch) const
+{
+    auto t0 = std::chrono::steady_clock::now();
+    SearchResult result;
+
+    if (prepared) {
+        const int w = snapshot.width;
+        const int h = snapshot.height;
+        const float* goalRow = table.row(goal);
+
+        scratch.beginQuery(snapshot.cellCount());
+        scratch.touch(start);
+        scratch.distance[start] = 0.0f;
+        scratch.open.push_back({lowerBound(start, goalRow), start});
+
+        auto heapCmp = std::greater<std::pair<float, int>>();
+
+        while (!scratch.open.empty()) {
+            std::pop_heap(scratch.open.begin(), scratch.open.end(), heapCmp);
+            int cur = scratch.open.back().second;
+            scratch.open.pop_back();
+
+            if (scratch.closed[cur]) continue;
+            scratch.closed[cur] = 1;
+            result.nodesVisited++;
+
+            if (cur == goal) break;
+
+            int x = cur % w;
+            int y = cur / w;
+            int nbs[4];
+            int count = 0;
+            if (x + 1 < w)  nbs[count++] = cur + 1;
+            if (y - 1 >= 0) nbs[count++] = cur - w;
+            if (x - 1 >= 0) nbs[count++] = cur - 1;
+            if (y + 1 < h)  nbs[count++] = cur + w;
+
+            for (int i = 0; i < count; ++i) {
+                int nb = nbs[i];
+                if (snapshot.obstacle[nb]) continue;
+                scratch.touch(nb);
+                float newCost = scratch.distance[cur] + 1.0f;
+                if (newCost < scratch.distance[nb]) {
+                    scratch.distance[nb] = newCost;
+                    scratch.parent[nb] = cur;
+                    scratch.open.push_back({newCost + lowerBound(nb, goalRow), nb});
+                    std::push_heap(scratch.open.begin(), scratch.open.end(), heapCmp);
+                }
+            }
+        }
+
+        if (scratch.touched(goal) && (goal == start || scratch.parent[goal] != -1)) {
+            scratch.takePath(result.path);
+            tracePath(scratch.parent, goal, result.path);
+            result.pathLength = static_cast<int>(result.path.size()) - 1;
+            result.pathCost = scratch.distance[goal];
+        }
+    }
+
+    result.memoryBytes = scratch.memoryBytes() + result.path.capacity() * sizeof(int) + memoryBytes();
+    result.timeElapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now() - t0).count();
+    return result;
+}
+
+size_t LandmarkPlanner::memoryBytes() const
+{
+    return table.distance.capacity() * sizeof(float) + table.cells.capacity() * sizeof(int)
+         + snapshot.obstacle.capacity();
+}
+
+std::string LandmarkPlanner::statistics() const
+{
+    std::ostringstream text;
+    text << table.count << " landmarks";
+    return text.str();
+}
@@ -0,0 +1,79 @@
+#include "LineOfSight.h"
+#include "SearchEngine.h"
+#include <algorithm>
+#include <cstdlib>
+
+LineOfSight::LineOfSight(int cacheSlots)
+{
+    size_t size = 1;
+    while (size < static_cast<size_t>(std::max(1, cacheSlots))) size <<= 1;
+    mask = size - 1;
+    slotCount = size;
+}
+
+void LineOfSight::begin(const GridSnapshot& grid)
+{
+    snapshot = &grid;
+    callCount = 0;
+    hitCount = 0;
+    // Slots are allocated on first use, so scratches that never trace stay small
+    if (slots.empty()) slots.assign(slotCount, Slot{0, 0, 0});
+    if (++stamp == 0) {
+        std::fill(slots.begin(), slots.end(), Slot{0, 0, 0});
+        stamp = 1;
+    }
+}
+
+bool LineOfSight::visible(int a, int b)
+{
+    callCount++;
+    if (a > b) std::swap(a, b);
+    const uint64_t key = static_cast<uint64_t>(a) << 32 | static_cast<uint32_t>(b);
+    Slot& slot = slots[(key * 0x9E3779B97F4A7C15ull >> 32) & mask];
+    if (slot.stamp == stamp && slot.key == key) {
+        hitCount++;
+        return slot.visible;
+    }
+    slot.key = key;
+    slot.stamp = stamp;
+    slot.visible = trace(a, b);
+    return slot.visible;
+}
+
+bool LineOfSight::trace(int a, int b) const
+{
+    const int w = snapshot->width;
+    const std::vector<uint8_t>& obstacle = snapshot->obstacle;
+    const int x0 = a % w, y0 = a / w;
+    const int x1 = b % w, y1 = b / w;
+    const int dx = std::abs(x1 - x0), dy = std::abs(y1 - y0);
+    const int sx = x1 > x0 ? 1 : -1;
+    const int sy = y1 > y0 ? w : -w;
+
+    // Walk the cells the segment enters. error compares how far the segment
+    // is past the next vertical and horizontal cell borders, scaled by 2.
+    int cell = a;
+    int error = dx - dy;
+    for (int n = dx + dy; n > 0; --n) {
+        if (error > 0) {
+            cell += sx;
+            error -= 2 * dy;
+        } else if (error < 0) {
+            cell += sy;
+            error += 2 * dx;
+        } else {
+            // Exactly through a corner: both side cells must be free
+            if (obstacle[cell + sx] || obstacle[cell + sy]) return false;
+            cell += sx + sy;
+            error += 2 * dx - 2 * dy;
+            --n;
+        }
+        if (obstacle[cell]) return false;
+    }
+    return true;
+}
+
+size_t LineOfSight::memoryBytes() const
+{
+    return slots.capacity() * sizeof(Slot);
+}
@@ -0,0 +1,228 @@
+#include "LocalSearch.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <utility>
+
+namespace {
+
+// State of the reached cells in the hash table
+struct SparseState
+{
+    SparseCellMap& map;
+    size_t limit;
+
+    bool full() const { return map.size() > limit; }
+
+    // Closes an open cell and gives its cost; false when it was closed before
+    bool close(int cell, float& distance)
+    {
+        SparseCellMap::Slot& slot = map.insert(cell);
+        if (slot.closed) return false;
+        slot.closed = 1;
+        distance = slot.distance;
+        return true;
+    }
+
+    bool relax(int cell, float distance, int parent)
+    {
+        SparseCellMap::Slot& slot = map.insert(cell);
+        if (!(distance < slot.distance)) return false;
+        slot.distance = distance;
+        slot.parent = parent;
+        return true;
+    }
+
+    const SparseCellMap::Slot* at(int cell) const { return map.find(cell); }
+    bool reached(int cell) const { return at(cell) && at(cell)->parent != -1; }
+    int parentOf(int cell) const { return at(cell)->parent; }
+    float distanceOf(int cell) const { return at(cell)->distance; }
+};
+
+// State of the reached cells in the scratch's stamped dense arrays
+struct DenseState
+{
+    SearchScratch& scratch;
+
+    bool full() const { return false; }
+
+    bool close(int cell, float& distance)
+    {
+        scratch.touch(cell);
+        if (scratch.closed[cell]) return false;
+        scratch.closed[cell] = 1;
+        distance = scratch.distance[cell];
+        return true;
+    }
+
+    bool relax(int cell, float distance, int parent)
+    {
+        scratch.touch(cell);
+        if (!(distance < scratch.distance[cell])) return false;
+        scratch.distance[cell] = distance;
+        scratch.parent[cell] = parent;
+        return true;
+    }
+
+    bool reached(int cell) const { return scratch.touched(cell) && scratch.parent[cell] != -1; }
+    int parentOf(int cell) const { return scratch.parent[cell]; }
+    float distanceOf(int cell) const { return scratch.distance[cell]; }
+};
+
+// One query, with the cell layout of its snapshot (RowMajorLayout or TiledLayout)
+template <class Cells>
+struct Query
+{
+    const GridSnapshot& snapshot;
+    Cells cells;
+    int goal;
+    int startX, startY;
+    int goalX, goalY;
+    int radius;
+};
+
+// Expands cells until the goal is closed or the open set runs out (true),
+// or until the state is full (false), leaving the open set to continue from
+template <class Cells, class State>
+bool expand(const Query<Cells>& query, State& state, std::vector<std::pair<float, int>>& open, SearchResult& result)
+{
+    [[maybe_unused]] SearchStats& stats = result.stats;
+    const GridSnapshot& snapshot = query.snapshot;
+    const int w = snapshot.width;
+    const int h = snapshot.height;
+    auto heapCmp = std::greater<std::pair<float, int>>();
+
+    while (!open.empty()) {
+        if (state.full()) return false;
+        std::pop_heap(open.begin(), open.end(), heapCmp);
+        const int cur = open.back().second;
+        open.pop_back();
+        SEARCH_STAT(stats.pops++);
+
+        float distance;
+        if (!state.close(cur, distance)) {
+            SEARCH_STAT(stats.stalePops++);
+            continue;
+        }
+        result.nodesVisited++;
+        if (cur == query.goal) return true;
+
+        int x, y;
+        query.cells.coords(cur, x, y);
+        for (int dir = 0; dir < FourConnected::count; ++dir) {
+            const int nx = x + FourConnected::dx[dir];
+            const int ny = y + FourConnected::dy[dir];
+            if (nx < 0 || nx >= w || ny < 0 || ny >= h) continue;
+            const int nb = query.cells.index(nx, ny);
+            if (snapshot.obstacle[nb]) continue;
+            if (query.radius > 0 && std::abs(nx - query.startX) + std::abs(ny - query.startY) > query.radius) continue;
+            SEARCH_STAT(stats.relaxations++);
+            const float candidate = distance + snapshot.costAt(nb) * FourConnected::multiplier[dir];
+            if (state.relax(nb, candidate, cur)) {
+                const float estimate = static_cast<float>(std::abs(nx - query.goalX) + std::abs(ny - query.goalY));
+                open.push_back({candidate + estimate, nb});
+                std::push_heap(open.begin(), open.end(), heapCmp);
+                SEARCH_STAT(stats.pushes++; stats.peakOpen = std::max(stats.peakOpen, open.size()));
+            }
+        }
+    }
+    return true;
+}
+
+// Fills path back to front from the goal's parent chain, as tracePath does
+template <class State>
+void traceChain(const State& state, int goal, std::vector<int>& path)
+{
+    size_t length = 1;
+    for (int cell = goal; state.parentOf(cell) != -1; cell = state.parentOf(cell)) length++;
+    path.resize(length);
+    int cell = goal;
+    for (size_t slot = length; slot-- > 0;) {
+        path[slot] = cell;
+        if (slot) cell = state.parentOf(cell);
+    }
+}
+
+template <class State>
+void finish(const State& state, int start, int goal, SearchScratch& scratch, SearchResult& result)
+{
+    if (goal != start && !state.reached(goal)) return;
+    scratch.takePath(result.path);
+    traceChain(state, goal, result.path);
+    result.pathLength = static_cast<int>(result.path.size()) - 1;
+    result.pathCost = state.distanceOf(goal);
+}
+
+template <class Cells>
+SearchResult search(const GridSnapshot& snapshot, int start, int goal, SearchScratch& scratch,
+                    const LocalSearchOptions& options)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    SearchResult result;
+
+    Query<Cells> query = {snapshot, Cells{snapshot.width, snapshot.height}, goal, 0, 0, 0, 0, options.radius};
+    query.cells.coords(start, query.startX, query.startY);
+    query.cells.coords(goal, query.goalX, query.goalY);
+    const size_t threshold = options.denseThreshold > 0
+                                 ? static_cast<size_t>(options.denseThreshold)
+                                 : std::max<size_t>(4096, static_cast<size_t>(snapshot.cellCount()) / 16);
+
+    SparseState sparse = {scratch.sparse, threshold};
+    scratch.sparse.clear();
+    scratch.open.clear();
+    scratch.sparse.insert(start).distance = 0.0f;
+    scratch.open.push_back({0.0f, start});
+    SEARCH_STAT(result.stats.pushes = 1; result.stats.peakOpen = 1);
+
+    // A goal beyond the radius cannot be reached, whatever the obstacles
+    const bool goalInside = options.radius <= 0
+                         || std::abs(query.goalX - query.startX) + std::abs(query.goalY - query.startY) <= options.radius;
+
+    size_t stateBytes;
+    if (!goalInside || expand(query, sparse, scratch.open, result)) {
+        finish(sparse, start, goal, scratch, result);
+        stateBytes = scratch.sparse.memoryBytes();
+    } else {
+        // Too many cells for the table: copy them into the dense arrays and go on
+        // there. beginQuery() empties the open set, so it is parked meanwhile.
+        std::swap(scratch.open, scratch.backwardOpen);
+        scratch.beginQuery(snapshot.cellCount());
+        std::swap(scratch.open, scratch.backwardOpen);
+        scratch.sparse.forEach([&scratch](const SparseCellMap::Slot& slot) {
+            scratch.touch(slot.cell);
+            scratch.distance[slot.cell] = slot.distance;
+            scratch.parent[slot.cell] = slot.parent;
+            scratch.closed[slot.cell] = static_cast<uint8_t>(slot.closed);
+        });
+        DenseState dense = {scratch};
+        expand(query, dense, scratch.open, result);
+        finish(dense, start, goal, scratch, result);
+        stateBytes = scratch.sparse.memoryBytes() + scratch.distance.capacity() * sizeof(float)
+                   + scratch.parent.capacity() * sizeof(int) + scratch.closed.capacity()
+                   + scratch.stamp.capacity() * sizeof(uint32_t);
+    }
+
+    result.timeElapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now() - t0).count();
+    // Only what this query used, not the buffers other solvers left in the scratch
+    result.memoryBytes = stateBytes + scratch.open.capacity() * sizeof(std::pair<float, int>)
+                       + result.path.capacity() * sizeof(int);
+    SEARCH_STAT(result.stats.peakMemoryBytes = result.memoryBytes);
+    return result;
+}
+
+} // namespace
+
+SearchResult localSearch(const GridSnapshot& snapshot, int start, int goal, SearchScratch& scratch,
+                         const LocalSearchOptions& options)
+{
+    if (snapshot.layout == LAYOUT_TILED)
+        return search<TiledLayout>(snapshot, start, goal, scratch, options);
+    return search<RowMajorLayout>(snapshot, start, goal, scratch, options);
+}
+
+SearchResult localAStarSearch(const GridSnapshot& snapshot, int start, int goal, SearchScratch& scratch)
+{
+    return localSearch(snapshot, start, goal, scratch, LocalSearchOptions());
+}
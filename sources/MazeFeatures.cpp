@@ -0,0 +1,138 @@
+#include "MazeFeatures.h"
+
+namespace {
+
+inline int bitCount(uint64_t word)
+{
+#if defined(__GNUC__)
+    return __builtin_popcountll(word);
+#else
+    int count = 0;
+    for (; word; word &= word - 1) ++count;
+    return count;
+#endif
+}
+
+} // namespace
+
+void MazeFeatureIndex::clear()
+{
+    built = false;
+    width = height = stride = 0;
+    layout = LAYOUT_ROW_MAJOR;
+    freePlane.clear();
+    freeCount = deadEndCount = adjacentPairs = 0;
+}
+
+void MazeFeatureIndex::build(const GridSnapshot& snapshot)
+{
+    width = snapshot.width;
+    height = snapshot.height;
+    layout = snapshot.layout;
+    const int words = (width + 63) / 64;
+    stride = words + 2;
+    freePlane.assign(static_cast<size_t>(stride) * (height + 2), 0);
+    freeCount = deadEndCount = adjacentPairs = 0;
+
+    auto packRow = [&](int y) {
+        uint64_t* row = &freePlane[static_cast<size_t>(y + 1) * stride + 1];
+        if (layout == LAYOUT_ROW_MAJOR) {
+            const uint8_t* obstacle = &snapshot.obstacle[static_cast<size_t>(y) * width];
+            for (int x = 0; x < width; ++x)
+                row[x >> 6] |= static_cast<uint64_t>(!obstacle[x]) << (x & 63);
+        } else {
+            for (int x = 0; x < width; ++x)
+                row[x >> 6] |= static_cast<uint64_t>(!snapshot.obstacle[snapshot.cellAt(x, y)]) << (x & 63);
+        }
+    };
+
+    // Row y is counted as soon as the row above it is packed
+    if (height > 0) packRow(0);
+    for (int y = 0; y < height; ++y) {
+        if (y + 1 < height) packRow(y + 1);
+
+        const uint64_t* row = &freePlane[static_cast<size_t>(y + 1) * stride + 1];
+        for (int i = 0; i < words; ++i) {
+            const uint64_t cells = row[i];
+            const uint64_t east = (cells >> 1) | (row[i + 1] << 63);
+            const uint64_t west = (cells << 1) | (row[i - 1] >> 63);
+            const uint64_t north = row[i + stride];
+            const uint64_t south = row[i - stride];
+
+            // Exactly one free neighbour: odd count and no pair among them
+            const uint64_t oneOfFour = (east ^ west ^ north ^ south) & ~((east & west) | (north & south));
+
+            freeCount += bitCount(cells);
+            adjacentPairs += bitCount(cells & east) + bitCount(cells & north);
+            deadEndCount += bitCount(cells & oneOfFour);
+        }
+    }
+    built = true;
+}
+
+bool MazeFeatureIndex::isFree(int x, int y) const
+{
+    return (freePlane[static_cast<size_t>(y + 1) * stride + 1 + (x >> 6)] >> (x & 63)) & 1;
+}
+
+int MazeFeatureIndex::freeNeighbours(int x, int y) const
+{
+    // The guard words and rows read as walls, bits past the width are zero
+    return (x + 1 < width && isFree(x + 1, y)) + isFree(x, y - 1)
+         + (x > 0 && isFree(x - 1, y)) + isFree(x, y + 1);
+}
+
+void MazeFeatureIndex::countAround(int x, int y, int sign)
+{
+    if (isFree(x, y)) {
+        freeCount += sign;
+        adjacentPairs += sign * freeNeighbours(x, y);
+    }
+    const int dx[5] = {0, 1, 0, -1, 0};
+    const int dy[5] = {0, 0, -1, 0, 1};
+    for (int k = 0; k < 5; ++k) {
+        const int nx = x + dx[k];
+        const int ny = y + dy[k];
+        if (nx < 0 || nx >= width || ny < 0 || ny >= height) continue;
+        if (isFree(nx, ny) && freeNeighbours(nx, ny) == 1) deadEndCount += sign;
+    }
+}
+
+void MazeFeatureIndex::setObstacle(int index, bool obstacle)
+{
+    if (!built) return;
+    int x, y;
+    if (layout == LAYOUT_TILED)
+        TiledLayout{width, height}.coords(index, x, y);
+    else
+        RowMajorLayout{width, height}.coords(index, x, y);
+    if (isFree(x, y) != obstacle) return;
+
+    countAround(x, y, -1);
+    freePlane[static_cast<size_t>(y + 1) * stride + 1 + (x >> 6)] ^= uint64_t(1) << (x & 63);
+    countAround(x, y, +1);
+}
+
+float MazeFeatureIndex::wallDensity() const
+{
+    const long long total = static_cast<long long>(width) * height;
+    return total ? static_cast<float>(total - freeCount) / total : 0.0f;
+}
+
+float MazeFeatureIndex::branchingFactor() const
+{
+    return freeCount ? 2.0f * adjacentPairs / freeCount : 0.0f;
+}
+
+MazeFeatures MazeFeatureIndex::features(int shortestPathLength, int nodesVisited) const
+{
+    MazeFeatures result;
+    result.gridWidth = width;
+    result.gridHeight = height;
+    result.wallDensity = wallDensity();
+    result.shortestPathLength = shortestPathLength;
+    result.nodesVisited = nodesVisited;
+    result.numDeadEnds = static_cast<int>(deadEndCount);
+    result.branchingFactor = branchingFactor();
+    return result;
+}
@@ -1,133 +1,129 @@
 #include "PathAlgorithm.h"
-#include <QtConcurrent>
-#include <QFuture>
 #include <iostream>
 #include <stack>
-#include <chrono>
-#include <thread>
 #include <QDebug>
-#include <QThread>
 
 // Recursive Backtracker maze generation
-void PathAlgorithm::performRecursiveBackTrackerAlgorithm(QPromise<int>& promise)
+MazeStepper::MazeStepper(const grid& g, int w, int h)
+    : gridNodes(g), widthGrid(w), heightGrid(h), phase(WALLS), visitedCount(0)
 {
-    qDebug() << "Maze (Recursive Backtracker): started in thread" << QThread::currentThreadId();
-    promise.suspendIfRequested();
-    if (promise.isCanceled()) {
-        emit pathfindingSearchCompleted(0, 0);
-        return;
+}
+
+bool MazeStepper::finished() const { return phase == DONE; }
+const grid& MazeStepper::getGrid() const { return gridNodes; }
+
+bool MazeStepper::step(int n, std::vector<StepUpdate>& updates)
+{
+    for (int i = 0; i < n && phase != DONE; ++i) {
+        if (phase == WALLS)
+            buildWalls(updates);
+        else
+            carveNext(updates);
     }
+    return phase != DONE;
+}
 
+void MazeStepper::buildWalls(std::vector<StepUpdate>& updates)
+{
     // Initialize all cells as obstacles (except start/end)
+    gridNodes.beginSearch();
     for (int idx = 0; idx < widthGrid * heightGrid; ++idx) {
-        promise.suspendIfRequested();
-        if (promise.isCanceled()) {
-            emit pathfindingSearchCompleted(0, 0);
-            return;
-        }
         if (idx != gridNodes.startIndex && idx != gridNodes.endIndex) {
             gridNodes.Nodes[idx].obstacle = true;
-            emit updatedScatterGridView(FREETOOBSTACLE, idx);
+            updates.push_back({FREETOOBSTACLE, idx});
         }
     }
 
-    std::stack<Node*> stack;
     // Random starting cell for maze generation
     int startMazeIdx = rand() % (widthGrid * heightGrid);
-    Node* startMaze = &gridNodes.Nodes[startMazeIdx];
+    Node* startMaze = &gridNodes.touch(startMazeIdx);
     stack.push(startMaze);
     startMaze->visited = true;
     if (startMaze->obstacle) {
         startMaze->obstacle = false;
-        emit updatedScatterGridView(OBSTACLETOFREE, startMazeIdx);
+        updates.push_back({OBSTACLETOFREE, startMazeIdx});
     }
 
-    int visitedCount = 1;
-    const int step = 2; // carve paths moving 2 cells
+    visitedCount = 1;
+    phase = CARVE;
+}
 
-    while (visitedCount < widthGrid * heightGrid && !stack.empty()) {
-        promise.suspendIfRequested();
-        if (promise.isCanceled()) {
-            emit pathfindingSearchCompleted(0, 0);
-            return;
-        }
+void MazeStepper::carveNext(std::vector<StepUpdate>& updates)
+{
+    const int step = 2; // carve paths moving 2 cells
 
-        Node* cur = stack.top();
-        std::vector<int> possibleDirs; // 0:E,1:S,2:W,3:N
+    if (visitedCount >= widthGrid * heightGrid || stack.empty()) {
+        // The next search starts a new epoch, so the visited flags can stay
+        phase = DONE;
+        return;
+    }
 
-        // Check two-step neighbors
-        // East
-        if (cur->xCoord + step <= widthGrid &&
-            !gridNodes.Nodes[coordToIndex(cur->xCoord + step, cur->yCoord, widthGrid)].visited) {
-            possibleDirs.push_back(0);
-        }
-        // South (y decreases)
-        if (cur->yCoord - step >= 1 &&
-            !gridNodes.Nodes[coordToIndex(cur->xCoord, cur->yCoord - step, widthGrid)].visited) {
-            possibleDirs.push_back(1);
-        }
-        // West
-        if (cur->xCoord - step >= 1 &&
-            !gridNodes.Nodes[coordToIndex(cur->xCoord - step, cur->yCoord, widthGrid)].visited) {
-            possibleDirs.push_back(2);
-        }
-        // North (y increases)
-        if (cur->yCoord + step <= heightGrid &&
-            !gridNodes.Nodes[coordToIndex(cur->xCoord, cur->yCoord + step, widthGrid)].visited) {
-            possibleDirs.push_back(3);
-        }
+    Node* cur = stack.top();
+    int possibleDirs[4]; // 0:E,1:S,2:W,3:N
+    int dirCount = 0;
 
-        if (!possibleDirs.empty()) {
-            int dir = possibleDirs[rand() % possibleDirs.size()];
-            int nx = cur->xCoord, ny = cur->yCoord;
-            int pathX = cur->xCoord, pathY = cur->yCoord;
-
-            switch (dir) {
-            case 0: // East
-                nx = cur->xCoord + step;
-                pathX = cur->xCoord + step - 1;
-                break;
-            case 1: // South
-                ny = cur->yCoord - step;
-                pathY = cur->yCoord - step + 1;
-                break;
-            case 2: // West
-                nx = cur->xCoord - step;
-                pathX = cur->xCoord - step + 1;
-                break;
-            case 3: // North
-                ny = cur->yCoord + step;
-                pathY = cur->yCoord + step - 1;
-                break;
-            }
-
-            // Carve the path cell
-            int pathIdx = coordToIndex(pathX, pathY, widthGrid);
-            gridNodes.Nodes[pathIdx].obstacle = false;
-            emit updatedScatterGridView(OBSTACLETOFREE, pathIdx);
-
-            // Carve the destination cell
-            int destIdx = coordToIndex(nx, ny, widthGrid);
-            Node* dest = &gridNodes.Nodes[destIdx];
-            dest->obstacle = false;
-            dest->visited = true;
-            emit updatedScatterGridView(OBSTACLETOFREE, destIdx);
-
-            stack.push(dest);
-            visitedCount++;
-        } else {
-            stack.pop();
-        }
+    // Check two-step neighbors
+    // East
+    if (cur->xCoord + step <= widthGrid &&
+        !gridNodes.touch(coordToIndex(cur->xCoord + step, cur->yCoord, widthGrid)).visited) {
+        possibleDirs[dirCount++] = 0;
+    }
+    // South (y decreases)
+    if (cur->yCoord - step >= 1 &&
+        !gridNodes.touch(coordToIndex(cur->xCoord, cur->yCoord - step, widthGrid)).visited) {
+        possibleDirs[dirCount++] = 1;
+    }
+    // West
+    if (cur->xCoord - step >= 1 &&
+        !gridNodes.touch(coordToIndex(cur->xCoord - step, cur->yCoord, widthGrid)).visited) {
+        possibleDirs[dirCount++] = 2;
+    }
+    // North (y increases)
+    if (cur->yCoord + step <= heightGrid &&
+        !gridNodes.touch(coordToIndex(cur->xCoord, cur->yCoord + step, widthGrid)).visited) {
+        possibleDirs[dirCount++] = 3;
+    }
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(speedVisualization));
+    if (dirCount == 0) {
+        stack.pop();
+        return;
     }
 
-    // Reset visited flags for future pathfinding
-    for (Node& node : gridNodes.Nodes) {
-        node.visited = false;
-        node.nextUp = false;
+    int dir = possibleDirs[rand() % dirCount];
+    int nx = cur->xCoord, ny = cur->yCoord;
+    int pathX = cur->xCoord, pathY = cur->yCoord;
+
+    switch (dir) {
+    case 0: // East
+        nx = cur->xCoord + step;
+        pathX = cur->xCoord + step - 1;
+        break;
+    case 1: // South
+        ny = cur->yCoord - step;
+        pathY = cur->yCoord - step + 1;
+        break;
+    case 2: // West
+        nx = cur->xCoord - step;
+        pathX = cur->xCoord - step + 1;
+        break;
+    case 3: // North
+        ny = cur->yCoord + step;
+        pathY = cur->yCoord + step - 1;
+        break;
     }
 
-    emit algorithmCompleted();
-    emit pathfindingSearchCompleted(0, 0); // maze generation: nodesVisited=0, pathLength=0
+    // Carve the path cell
+    int pathIdx = coordToIndex(pathX, pathY, widthGrid);
+    gridNodes.Nodes[pathIdx].obstacle = false;
+    updates.push_back({OBSTACLETOFREE, pathIdx});
+
+    // Carve the destination cell
+    int destIdx = coordToIndex(nx, ny, widthGrid);
+    Node* dest = &gridNodes.touch(destIdx);
+    dest->obstacle = false;
+    dest->visited = true;
+    updates.push_back({OBSTACLETOFREE, destIdx});
+
+    stack.push(dest);
+    visitedCount++;
 }
@@ -0,0 +1,466 @@
+#include "MultiAgentPlanner.h"
+#include "ComponentIndex.h"
+#include "JobExecutor.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <unordered_map>
+
+namespace {
+
+const uint64_t kKeyMask = (uint64_t(1) << 44) - 1;
+
+size_t slotFor(uint64_t key, int shift)
+{
+    return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> shift);
+}
+
+} // namespace
+
+// -----------------------------------------------------------------
+// ReservationTable
+// -----------------------------------------------------------------
+ReservationTable::ReservationTable() : cells(0), count(0), shift(64) {}
+
+void ReservationTable::reset(int cellCount)
+{
+    cells = static_cast<uint64_t>(cellCount);
+    count = 0;
+    slots.assign(size_t(1) << 16, 0);
+    shift = 64 - 16;
+}
+
+void ReservationTable::grow()
+{
+    std::vector<uint64_t> old;
+    old.swap(slots);
+    slots.assign(old.size() * 2, 0);
+    shift--;
+    const size_t mask = slots.size() - 1;
+    for (uint64_t slot : old) {
+        if (!slot) continue;
+        size_t i = slotFor(slot & kKeyMask, shift);
+        while (slots[i]) i = (i + 1) & mask;
+        slots[i] = slot;
+    }
+}
+
+void ReservationTable::reserve(int cell, int t, int agent)
+{
+    if ((count + 1) * 10 > slots.size() * 7) grow();
+    const uint64_t key = static_cast<uint64_t>(t) * cells + cell;
+    const size_t mask = slots.size() - 1;
+    size_t i = slotFor(key, shift);
+    while (slots[i] && (slots[i] & kKeyMask) != key) i = (i + 1) & mask;
+    if (!slots[i]) count++;
+    slots[i] = key | (static_cast<uint64_t>(agent + 1) << 44);
+}
+
+int ReservationTable::owner(int cell, int t) const
+{
+    const uint64_t key = static_cast<uint64_t>(t) * cells + cell;
+    const size_t mask = slots.size() - 1;
+    for (size_t i = slotFor(key, shift); slots[i]; i = (i + 1) & mask) {
+        if ((slots[i] & kKeyMask) == key) return static_cast<int>(slots[i] >> 44) - 1;
+    }
+    return -1;
+}
+
+size_t ReservationTable::size() const { return count; }
+
+size_t ReservationTable::memoryBytes() const
+{
+    return slots.capacity() * sizeof(uint64_t);
+}
+
+// -----------------------------------------------------------------
+// Space-time A*
+// -----------------------------------------------------------------
+void MultiAgentPlanner::Scratch::beginSearch()
+{
+    nodes.clear();
+    heap.clear();
+    if (seen.empty()) {
+        seen.assign(size_t(1) << 12, 0);
+        seenStamp.assign(seen.size(), 0);
+    }
+    if (++stamp == 0) {
+        std::fill(seenStamp.begin(), seenStamp.end(), 0);
+        stamp = 1;
+    }
+    seenCount = 0;
+}
+
+void MultiAgentPlanner::Scratch::clearGoalDistances(int cellCount)
+{
+    if (goalDistance.size() != size_t(cellCount)) {
+        goalDistance.assign(cellCount, -1);
+    } else {
+        for (int cell : queue)
+            goalDistance[cell] = -1;
+    }
+    queue.clear();
+}
+
+// False when the key was already in the set
+bool MultiAgentPlanner::Scratch::insert(uint64_t key)
+{
+    if ((seenCount + 1) * 2 > seen.size()) {
+        std::vector<uint64_t> oldKeys;
+        std::vector<uint32_t> oldStamps;
+        oldKeys.swap(seen);
+        oldStamps.swap(seenStamp);
+        seen.assign(oldKeys.size() * 2, 0);
+        seenStamp.assign(seen.size(), 0);
+        const size_t mask = seen.size() - 1;
+        const int bits = __builtin_ctzll(seen.size());
+        for (size_t j = 0; j < oldKeys.size(); ++j) {
+            if (oldStamps[j] != stamp) continue;
+            size_t i = slotFor(oldKeys[j], 64 - bits);
+            while (seenStamp[i] == stamp) i = (i + 1) & mask;
+            seen[i] = oldKeys[j];
+            seenStamp[i] = stamp;
+        }
+    }
+    const size_t mask = seen.size() - 1;
+    const int bits = __builtin_ctzll(seen.size());
+    size_t i = slotFor(key, 64 - bits);
+    while (seenStamp[i] == stamp) {
+        if (seen[i] == key) return false;
+        i = (i + 1) & mask;
+    }
+    seen[i] = key;
+    seenStamp[i] = stamp;
+    seenCount++;
+    return true;
+}
+
+MultiAgentPlanner::MultiAgentPlanner(const MultiAgentConfig& cfg) : config(cfg), horizon(0) {}
+
+size_t MultiAgentPlanner::reservationCount() const
+{
+    return reservations.size();
+}
+
+// Moving (or waiting, from == to) between t and t + 1 without entering a
+// reserved cell, a parked agent's goal or swapping places with another agent
+bool MultiAgentPlanner::canMove(int agent, int from, int to, int t) const
+{
+    if (parkedFrom[to] <= t + 1) return false;
+    int holder = reservations.owner(to, t + 1);
+    if (holder != -1 && holder != agent) return false;
+    if (from != to) {
+        int other = reservations.owner(to, t);
+        if (other != -1 && other != agent && reservations.owner(from, t + 1) == other) return false;
+    }
+    return true;
+}
+
+// An agent may only stop for good once nobody else passes its goal later
+bool MultiAgentPlanner::canStay(int agent, int goal, int arrival) const
+{
+    return lastReserved[goal] < arrival
+        || (lastReserved[goal] == 0 && reservations.owner(goal, 0) == agent);
+}
+
+int MultiAgentPlanner::padded(int cell) const
+{
+    const int w = snapshot.width;
+    return cell + (cell / w) * 2 + w + 3;
+}
+
+// Breadth-first search from the goal over the walled copy of the grid,
+// restricted to the cells whose Manhattan distances to goal and start sum to
+// at most the start's Manhattan distance plus a slack. The slack grows until
+// the start is labelled; on open or lightly cluttered maps the first pass
+// covers a narrow band around the straight line instead of the whole map.
+void MultiAgentPlanner::labelGoalDistances(const Agent& spec, Scratch& scratch) const
+{
+    const int stride = snapshot.width + 2;
+    const uint8_t* wall = walled.data();
+    int* dist = scratch.goalDistance.data();
+    std::vector<int>& queue = scratch.queue;
+
+    const int start = padded(spec.startIndex);
+    const int goal = padded(spec.goalIndex);
+    const int sx = start % stride, sy = start / stride;
+    const int gx = goal % stride, gy = goal / stride;
+    const int direct = std::abs(sx - gx) + std::abs(sy - gy);
+    const int widest = 2 * (snapshot.width + snapshot.height);
+
+    for (int slack = direct / 8 + 16; ; slack *= 4) {
+        for (int cell : queue)
+            dist[cell] = -1;
+        queue.clear();
+        queue.push_back(goal);
+        dist[goal] = 0;
+
+        const int limit = direct + slack;
+        auto inBand = [&](int x, int y) {
+            return std::abs(x - gx) + std::abs(y - gy) + std::abs(x - sx) + std::abs(y - sy) <= limit;
+        };
+        auto label = [&](int nb, int value) {
+            if (wall[nb] || dist[nb] >= 0) return;
+            dist[nb] = value;
+            queue.push_back(nb);
+        };
+        for (size_t head = 0; head < queue.size(); ++head) {
+            const int cell = queue[head];
+            const int next = dist[cell] + 1;
+            const int y = cell / stride;
+            const int x = cell - y * stride;
+            if (inBand(x + 1, y)) label(cell + 1, next);
+            if (inBand(x, y - 1)) label(cell - stride, next);
+            if (inBand(x - 1, y)) label(cell - 1, next);
+            if (inBand(x, y + 1)) label(cell + stride, next);
+        }
+        if (dist[start] >= 0 || limit > widest) return;
+    }
+}
+
+// Distance inside the searched band, which is exact unless the shortest path
+// leaves the band, and the Manhattan lower bound outside it
+int MultiAgentPlanner::distanceToGoal(int cell, const Agent& spec, const Scratch& scratch) const
+{
+    const int known = scratch.goalDistance[padded(cell)];
+    if (known >= 0) return known;
+    const int w = snapshot.width;
+    return std::abs(cell % w - spec.goalIndex % w) + std::abs(cell / w - spec.goalIndex / w);
+}
+
+// Most agents on open or lightly cluttered maps get through on the Manhattan
+// heuristic within a small budget; the rest retry with grid distances
+bool MultiAgentPlanner::planAgent(int agent, const Agent& spec, Scratch& scratch, std::vector<int>& path,
+                                  long long& expansions) const
+{
+    const int w = snapshot.width;
+    const int direct = std::abs(spec.startIndex % w - spec.goalIndex % w)
+                     + std::abs(spec.startIndex / w - spec.goalIndex / w);
+    scratch.clearGoalDistances(static_cast<int>(walled.size()));
+    if (searchAgent(agent, spec, std::min(config.maxExpansions, 8 * direct + 1024), scratch, path, expansions))
+        return true;
+    labelGoalDistances(spec, scratch);
+    return searchAgent(agent, spec, config.maxExpansions, scratch, path, expansions);
+}
+
+bool MultiAgentPlanner::searchAgent(int agent, const Agent& spec, int budget, Scratch& scratch,
+                                    std::vector<int>& path, long long& expansions) const
+{
+    typedef Scratch::Entry Entry;
+    const int w = snapshot.width;
+    const int h = snapshot.height;
+    const uint64_t cells = static_cast<uint64_t>(snapshot.cellCount());
+    // Lowest f first, ties towards the deeper node, then the closer one
+    auto later = [](const Entry& a, const Entry& b) {
+        return a.f > b.f || (a.f == b.f && (a.g < b.g || (a.g == b.g && a.h > b.h)));
+    };
+
+    // No arrival before the last agent crossing the goal has left it. Folding
+    // that into f keeps the search from widening while it waits.
+    const int earliestStop = canStay(agent, spec.goalIndex, 0) ? 0 : lastReserved[spec.goalIndex] + 1;
+    if (earliestStop > horizon) return false;
+
+    scratch.beginSearch();
+    scratch.insert(static_cast<uint64_t>(spec.startIndex));
+    scratch.nodes.push_back({spec.startIndex, 0, -1});
+    // Weighted A* in 1/16 steps: a weight above 1 lets the search commit to
+    // one of the many equally short routes instead of trying them all
+    const int weight = static_cast<int>(config.heuristicWeight * 16.0f + 0.5f);
+    auto priority = [&](int t, int remaining) {
+        return 16 * std::max(earliestStop, t + remaining) + (weight - 16) * remaining;
+    };
+
+    const int startDistance = distanceToGoal(spec.startIndex, spec, scratch);
+    scratch.heap.push_back({priority(0, startDistance), 0, startDistance, 0});
+
+    int expanded = 0;
+    bool found = false;
+    int goalNode = -1;
+    while (!scratch.heap.empty() && expanded < budget) {
+        std::pop_heap(scratch.heap.begin(), scratch.heap.end(), later);
+        const int current = scratch.heap.back().node;
+        scratch.heap.pop_back();
+        expanded++;
+
+        const int cell = scratch.nodes[current].cell;
+        const int t = scratch.nodes[current].t;
+
+        if (cell == spec.goalIndex && canStay(agent, cell, t)) {
+            found = true;
+            goalNode = current;
+            break;
+        }
+        if (t >= horizon) continue;
+
+        const int x = cell % w;
+        const int y = cell / w;
+        int nbs[5];
+        int count = 0;
+        nbs[count++] = cell;
+        if (x + 1 < w)  nbs[count++] = cell + 1;
+        if (y - 1 >= 0) nbs[count++] = cell - w;
+        if (x - 1 >= 0) nbs[count++] = cell - 1;
+        if (y + 1 < h)  nbs[count++] = cell + w;
+        for (int i = 0; i < count; ++i) {
+            const int next = nbs[i];
+            if (snapshot.obstacle[next] || !canMove(agent, cell, next, t)) continue;
+            const int remaining = distanceToGoal(next, spec, scratch);
+            if (t + 1 + remaining > horizon) continue;
+            if (!scratch.insert(static_cast<uint64_t>(t + 1) * cells + next)) continue;
+            scratch.nodes.push_back({next, t + 1, current});
+            scratch.heap.push_back({priority(t + 1, remaining), t + 1, remaining,
+                                    static_cast<int>(scratch.nodes.size()) - 1});
+            std::push_heap(scratch.heap.begin(), scratch.heap.end(), later);
+        }
+    }
+    expansions += expanded;
+
+    path.clear();
+    if (!found) return false;
+    for (int node = goalNode; node != -1; node = scratch.nodes[node].parent)
+        path.push_back(scratch.nodes[node].cell);
+    std::reverse(path.begin(), path.end());
+    return true;
+}
+
+bool MultiAgentPlanner::stillValid(int agent, const std::vector<int>& path) const
+{
+    for (size_t t = 0; t + 1 < path.size(); ++t) {
+        if (!canMove(agent, path[t], path[t + 1], static_cast<int>(t))) return false;
+    }
+    return canStay(agent, path.back(), static_cast<int>(path.size()) - 1);
+}
+
+void MultiAgentPlanner::commit(int agent, const std::vector<int>& path)
+{
+    // t = 0 was reserved for every agent before planning started
+    for (size_t t = 1; t < path.size(); ++t) {
+        reservations.reserve(path[t], static_cast<int>(t), agent);
+        lastReserved[path[t]] = std::max(lastReserved[path[t]], static_cast<int>(t));
+    }
+    parkedFrom[path.back()] = static_cast<int>(path.size()) - 1;
+}
+
+MultiAgentResult MultiAgentPlanner::plan(const GridSnapshot& grid, const std::vector<Agent>& agents)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    MultiAgentResult result;
+    snapshot = grid;
+    const int cellCount = snapshot.cellCount();
+    horizon = config.horizon > 0 ? config.horizon : 4 * (snapshot.width + snapshot.height);
+
+    reservations.reset(cellCount);
+    lastReserved.assign(cellCount, -1);
+    parkedFrom.assign(cellCount, horizon + 2);
+    result.paths.assign(agents.size(), std::vector<int>());
+
+    WorkStealingExecutor executor(config.threads, 1);
+    const int threads = executor.threadCount();
+
+    // Obstacle plane with a wall around it, so searches need no bounds checks
+    const int w = snapshot.width;
+    walled.assign(static_cast<size_t>(w + 2) * (snapshot.height + 2), 1);
+    for (int y = 0; y < snapshot.height; ++y)
+        std::copy(&snapshot.obstacle[y * w], &snapshot.obstacle[y * w] + w, &walled[padded(y * w)]);
+
+    // Agents whose goal lies in another region fail without a search
+    ComponentIndex components;
+    components.build(snapshot, threads);
+
+    // Every agent stands on its start at t = 0, planned or not
+    std::vector<uint8_t> valid(agents.size(), 0);
+    std::vector<uint8_t> goalTaken(cellCount, 0);
+    for (size_t a = 0; a < agents.size() && a < size_t(ReservationTable::kMaxAgents); ++a) {
+        const Agent& agent = agents[a];
+        if (agent.startIndex < 0 || agent.startIndex >= cellCount || agent.goalIndex < 0
+            || agent.goalIndex >= cellCount || snapshot.obstacle[agent.startIndex]
+            || snapshot.obstacle[agent.goalIndex] || lastReserved[agent.startIndex] == 0
+            || goalTaken[agent.goalIndex] || !components.connected(agent.startIndex, agent.goalIndex))
+            continue;
+        valid[a] = 1;
+        goalTaken[agent.goalIndex] = 1;
+        reservations.reserve(agent.startIndex, 0, static_cast<int>(a));
+        lastReserved[agent.startIndex] = 0;
+    }
+
+    const size_t batchSize = config.batchSize > 0 ? config.batchSize : 8 * threads;
+    std::vector<Scratch> scratch(threads);
+    std::vector<long long> expansions(threads, 0);
+    std::vector<uint8_t> speculative(batchSize);
+
+    for (size_t begin = 0; begin < agents.size(); begin += batchSize) {
+        const size_t end = std::min(agents.size(), begin + batchSize);
+
+        // Plan the whole batch against the table as committed so far
+        executor.run(end - begin, [&](size_t i, int worker) {
+            const size_t a = begin + i;
+            speculative[i] = valid[a] && planAgent(static_cast<int>(a), agents[a], scratch[worker],
+                                                   result.paths[a], expansions[worker]);
+        });
+
+        // Commit in priority order. More reservations only remove moves, so an
+        // agent without a speculative plan is not searched again.
+        for (size_t a = begin; a < end; ++a) {
+            if (!speculative[a - begin]) continue;
+            if (!stillValid(static_cast<int>(a), result.paths[a])) {
+                result.replans++;
+                if (!planAgent(static_cast<int>(a), agents[a], scratch[0], result.paths[a], expansions[0]))
+                    continue;
+            }
+            commit(static_cast<int>(a), result.paths[a]);
+        }
+    }
+
+    for (size_t a = 0; a < agents.size(); ++a) {
+        const std::vector<int>& path = result.paths[a];
+        if (path.empty()) {
+            result.failed++;
+            continue;
+        }
+        result.planned++;
+        result.makespan = std::max(result.makespan, static_cast<int>(path.size()) - 1);
+        result.sumOfCosts += static_cast<long long>(path.size()) - 1;
+    }
+    for (long long count : expansions)
+        result.expansions += count;
+
+    result.memoryBytes = reservations.memoryBytes() + walled.capacity() + (lastReserved.capacity() + parkedFrom.capacity()) * sizeof(int);
+    for (const Scratch& s : scratch) {
+        result.memoryBytes += s.nodes.capacity() * sizeof(Scratch::Node) + s.heap.capacity() * sizeof(Scratch::Entry)
+                            + s.seen.capacity() * sizeof(uint64_t) + s.seenStamp.capacity() * sizeof(uint32_t)
+                            + (s.goalDistance.capacity() + s.queue.capacity()) * sizeof(int);
+    }
+    result.timeElapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now() - t0).count();
+    return result;
+}
+
+long long countConflicts(const std::vector<std::vector<int>>& paths)
+{
+    size_t makespan = 0;
+    for (const std::vector<int>& path : paths)
+        makespan = std::max(makespan, path.size());
+
+    auto at = [](const std::vector<int>& path, size_t t) { return t < path.size() ? path[t] : path.back(); };
+
+    long long conflicts = 0;
+    std::unordered_map<int, int> previous, current;
+    for (size_t t = 0; t < makespan; ++t) {
+        current.clear();
+        for (size_t a = 0; a < paths.size(); ++a) {
+            if (paths[a].empty()) continue;
+            const int cell = at(paths[a], t);
+            if (!current.emplace(cell, static_cast<int>(a)).second) conflicts++;
+            if (t == 0) continue;
+            // Swap: the agent now on our previous cell was on our current one
+            const int from = at(paths[a], t - 1);
+            if (from == cell) continue;
+            auto before = previous.find(cell);
+            if (before != previous.end() && before->second != static_cast<int>(a)
+                && at(paths[before->second], t) == from)
+                conflicts++;
+        }
+        previous.swap(current);
+    }
+    return conflicts;
+}
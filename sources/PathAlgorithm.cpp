@@ -1,5 +1,7 @@
 #include "PathAlgorithm.h"
+#include "TraceEvents.h"
 #include "QtConcurrent/qtconcurrentrun.h"
+#include <algorithm>
 #include <iostream>
 #include <queue>
 #include <map>
@@ -20,6 +22,9 @@ PathAlgorithm::PathAlgorithm(QObject* parent) : QObject(parent)
     simulationOnGoing = false;
     endReached = false;
     speedVisualization = 250;
+    stepsPerTick = 1;
+
+    connect(&stepTimer, &QTimer::timeout, this, &PathAlgorithm::advanceSimulation);
 }
 
 // Destructor
@@ -27,62 +32,50 @@ PathAlgorithm::~PathAlgorithm() {}
 
 ALGOS PathAlgorithm::getCurrentAlgorithm() const { return currentAlgorithm; }
 void PathAlgorithm::setCurrentAlgorithm(ALGOS algorithm) { currentAlgorithm = algorithm; }
-void PathAlgorithm::setSpeedVizualization(int speed) { speedVisualization = speed; }
 void PathAlgorithm::setSimulationOnGoing(bool onGoing) { simulationOnGoing = onGoing; }
+void PathAlgorithm::setStepsPerTick(int steps) { stepsPerTick = qMax(1, steps); }
+
+void PathAlgorithm::setSpeedVizualization(int speed)
+{
+    speedVisualization = speed;
+    stepTimer.setInterval(speedVisualization);
+}
 
 void PathAlgorithm::setGridNodes(const grid& newGridNodes, int width, int height)
 {
     gridNodes = newGridNodes;
     widthGrid = width;
     heightGrid = height;
-    for (Node& node : gridNodes.Nodes) {
-        node.visited = false;
-        node.nextUp = false;
-    }
+    // The steppers call beginSearch(), so stale visited flags need no reset pass
 }
 
 std::vector<Node> PathAlgorithm::retrieveNeighborsGrid(const grid& g, const Node& currentNode, int w, int h)
 {
     std::vector<Node> neighbors;
-    if (currentNode.xCoord + 1 <= w) {
-        int idx = coordToIndex(currentNode.xCoord + 1, currentNode.yCoord, w);
-        neighbors.push_back(g.Nodes[idx]);
-    }
-    if (currentNode.yCoord - 1 >= 1) {
-        int idx = coordToIndex(currentNode.xCoord, currentNode.yCoord - 1, w);
-        neighbors.push_back(g.Nodes[idx]);
-    }
-    if (currentNode.xCoord - 1 >= 1) {
-        int idx = coordToIndex(currentNode.xCoord - 1, currentNode.yCoord, w);
-        neighbors.push_back(g.Nodes[idx]);
-    }
-    if (currentNode.yCoord + 1 <= h) {
-        int idx = coordToIndex(currentNode.xCoord, currentNode.yCoord + 1, w);
-        neighbors.push_back(g.Nodes[idx]);
+    for (int dir = 0; dir < FourConnected::count; ++dir) {
+        int x = currentNode.xCoord + FourConnected::dx[dir];
+        int y = currentNode.yCoord + FourConnected::dy[dir];
+        if (x >= 1 && x <= w && y >= 1 && y <= h)
+            neighbors.push_back(g.Nodes[coordToIndex(x, y, w)]);
     }
     return neighbors;
 }
 
-void PathAlgorithm::FillNeighboursNode(Node& node)
+void fillNodeNeighbours(grid& g, Node& node, int w, int h)
 {
-    if (node.xCoord + 1 <= widthGrid) {
-        int idx = coordToIndex(node.xCoord + 1, node.yCoord, widthGrid);
-        node.neighbours.push_back(&gridNodes.Nodes[idx]);
-    }
-    if (node.yCoord - 1 >= 1) {
-        int idx = coordToIndex(node.xCoord, node.yCoord - 1, widthGrid);
-        node.neighbours.push_back(&gridNodes.Nodes[idx]);
-    }
-    if (node.xCoord - 1 >= 1) {
-        int idx = coordToIndex(node.xCoord - 1, node.yCoord, widthGrid);
-        node.neighbours.push_back(&gridNodes.Nodes[idx]);
-    }
-    if (node.yCoord + 1 <= heightGrid) {
-        int idx = coordToIndex(node.xCoord, node.yCoord + 1, widthGrid);
-        node.neighbours.push_back(&gridNodes.Nodes[idx]);
+    for (int dir = 0; dir < FourConnected::count; ++dir) {
+        int x = node.xCoord + FourConnected::dx[dir];
+        int y = node.yCoord + FourConnected::dy[dir];
+        if (x >= 1 && x <= w && y >= 1 && y <= h)
+            node.neighbours.push_back(&g.Nodes[coordToIndex(x, y, w)]);
     }
 }
 
+void PathAlgorithm::FillNeighboursNode(Node& node)
+{
+    fillNodeNeighbours(gridNodes, node, widthGrid, heightGrid);
+}
+
 void PathAlgorithm::checkGridNode(grid g, int h, int w)
 {
     Q_UNUSED(g);
@@ -92,143 +85,263 @@ void PathAlgorithm::checkGridNode(grid g, int h, int w)
 
 void PathAlgorithm::runAlgorithm(ALGOS algorithm)
 {
+    TRACE_SCOPE("start algorithm", "solver");
     simulationOnGoing = true;
     running = true;
+    dijkstraStepper.reset();
+    mazeStepper.reset();
+
     switch (algorithm) {
     case DIJKSTRA:
-        futureOutput = QtConcurrent::run(&pool, &PathAlgorithm::performDijkstraAlgorithm, this);
+        dijkstraStepper = std::make_unique<DijkstraStepper>(gridNodes, widthGrid, heightGrid);
         break;
     case BACKTRACK:
-        futureOutput = QtConcurrent::run(&pool, &PathAlgorithm::performRecursiveBackTrackerAlgorithm, this);
+        mazeStepper = std::make_unique<MazeStepper>(gridNodes, widthGrid, heightGrid);
         break;
     default:
-        break;
+        return;
     }
+    stepTimer.start(speedVisualization);
 }
 
 void PathAlgorithm::resumeAlgorithm()
 {
     running = true;
-    futureOutput.resume();
+    if (dijkstraStepper || mazeStepper)
+        stepTimer.start(speedVisualization);
 }
 
 void PathAlgorithm::pauseAlgorithm()
 {
     running = false;
-    futureOutput.suspend();
+    stepTimer.stop();
 }
 
 void PathAlgorithm::stopAlgorithm()
 {
     running = false;
-    futureOutput.cancel();
+    stepTimer.stop();
+    lastSearchStats = SearchStats();
+    lastSearchTiming = SearchTiming();
+    if (dijkstraStepper && !dijkstraStepper->searchFinished()) {
+        lastSearchStats = dijkstraStepper->stats();
+        lastSearchTiming = dijkstraStepper->timing();
+        emit pathfindingSearchCompleted(dijkstraStepper->nodesVisited(), 0);
+    } else if (mazeStepper) {
+        emit pathfindingSearchCompleted(0, 0);
+    }
+    dijkstraStepper.reset();
+    mazeStepper.reset();
 }
 
-// -----------------------------------------------------------------
-// Dijkstra Implementation
-// -----------------------------------------------------------------
-void PathAlgorithm::performDijkstraAlgorithm(QPromise<int>& promise)
+void PathAlgorithm::emitStepUpdates()
 {
-    qDebug() << "Dijkstra: started in thread" << QThread::currentThreadId();
-    promise.suspendIfRequested();
-    if (promise.isCanceled()) {
-        emit pathfindingSearchCompleted(0, 0);
-        return;
+    TRACE_SCOPE("emit step updates", "signals");
+    for (const StepUpdate& update : stepUpdates) {
+        if (update.type == LINE) {
+            QPointF point(update.index % widthGrid + 1, update.index / widthGrid + 1);
+            emit updatedLineGridView(point, true, update.clearPrior);
+        } else {
+            emit updatedScatterGridView(update.type, update.index);
+        }
     }
+    stepUpdates.clear();
+}
 
-    // Reset nodes
-    for (Node& node : gridNodes.Nodes) {
-        node.neighbours.clear();
-        FillNeighboursNode(node);
-        node.localGoal = INFINITY;
-        node.parent = nullptr;
-        node.visited = false;
+void PathAlgorithm::advanceSimulation()
+{
+    TRACE_SCOPE("simulation tick", "solver");
+    if (dijkstraStepper) {
+        bool wasSearching = !dijkstraStepper->searchFinished();
+        {
+            TRACE_SCOPE("dijkstra step", "solver");
+            dijkstraStepper->step(stepsPerTick, stepUpdates);
+        }
+        emitStepUpdates();
+
+        if (wasSearching && dijkstraStepper->searchFinished()) {
+            lastSearchStats = dijkstraStepper->stats();
+            lastSearchTiming = dijkstraStepper->timing();
+            emit pathfindingSearchCompleted(dijkstraStepper->nodesVisited(), dijkstraStepper->pathLength());
+        }
+
+        if (dijkstraStepper->finished()) {
+            stepTimer.stop();
+            dijkstraStepper.reset();
+            emit algorithmCompleted();
+        }
+    } else if (mazeStepper) {
+        {
+            TRACE_SCOPE("maze step", "solver");
+            mazeStepper->step(stepsPerTick, stepUpdates);
+        }
+        emitStepUpdates();
+
+        if (mazeStepper->finished()) {
+            stepTimer.stop();
+            // Keep the carved maze for the next run
+            const grid& maze = mazeStepper->getGrid();
+            for (size_t idx = 0; idx < gridNodes.Nodes.size(); ++idx)
+                gridNodes.Nodes[idx].obstacle = maze.Nodes[idx].obstacle;
+            mazeStepper.reset();
+
+            emit algorithmCompleted();
+            lastSearchStats = SearchStats();
+            lastSearchTiming = SearchTiming();
+            emit pathfindingSearchCompleted(0, 0); // maze generation: nodesVisited=0, pathLength=0
+        }
+    } else {
+        stepTimer.stop();
     }
+}
 
-    auto distance = [](Node* a, Node* b) {
-        float dx = a->xCoord - b->xCoord;
-        float dy = a->yCoord - b->yCoord;
-        return sqrtf(dx*dx + dy*dy);
-    };
+// -----------------------------------------------------------------
+// Dijkstra Implementation
+// -----------------------------------------------------------------
+DijkstraStepper::DijkstraStepper(const grid& g, int w, int h)
+    : gridNodes(g), widthGrid(w), heightGrid(h), phase(SEARCHING), visitedCount(0), pathCursor(0)
+{
+    terrain.build(snapshotFromGrid(gridNodes, widthGrid, heightGrid));
 
-    Node* start = &gridNodes.Nodes[gridNodes.startIndex];
-    Node* goal  = &gridNodes.Nodes[gridNodes.endIndex];
+    // Nodes are reset lazily when the search first reaches them
+    gridNodes.beginSearch();
+    Node* start = &gridNodes.touch(gridNodes.startIndex);
     start->localGoal = 0.0f;
-
-    std::priority_queue<Node*, std::vector<Node*>, CompareNodesDijkstra> open;
     open.push(start);
+    SEARCH_STAT(searchStats.pushes = 1; searchStats.peakOpen = 1);
+    timer.pause();
+}
 
-    int visitedCount = 0;
+bool DijkstraStepper::searchFinished() const { return phase != SEARCHING; }
+bool DijkstraStepper::finished() const { return phase == DONE; }
+int DijkstraStepper::nodesVisited() const { return visitedCount; }
+int DijkstraStepper::pathLength() const { return path.empty() ? 0 : static_cast<int>(path.size()) - 1; }
 
-    while (!open.empty()) {
-        promise.suspendIfRequested();
-        if (promise.isCanceled()) {
-            emit pathfindingSearchCompleted(visitedCount, 0);
-            return;
-        }
+bool DijkstraStepper::step(int n, std::vector<StepUpdate>& updates)
+{
+    if (phase == SEARCHING) timer.resume(PHASE_SEARCH);
+    for (int i = 0; i < n && phase != DONE; ++i) {
+        if (phase == SEARCHING)
+            expandNext(updates);
+        else
+            drawNextPathCell(updates);
+    }
+    timer.pause();
+    return phase != DONE;
+}
 
-        Node* cur = open.top();
+void DijkstraStepper::expandNext(std::vector<StepUpdate>& updates)
+{
+    Node* goal = &gridNodes.Nodes[gridNodes.endIndex];
+
+    // Skip stale entries so every step expands exactly one node
+    Node* cur = nullptr;
+    while (!open.empty() && cur == nullptr) {
+        cur = open.top();
         open.pop();
+        SEARCH_STAT(searchStats.pops++);
+        if (cur->visited) {
+            SEARCH_STAT(searchStats.stalePops++);
+            cur = nullptr;
+        }
+    }
+    if (cur == nullptr) {
+        finishSearch();
+        return;
+    }
+
+    cur->visited = true;
+    visitedCount++;
 
-        if (cur->visited) continue;
-        cur->visited = true;
-        visitedCount++;
-
-        int curIdx = coordToIndex(cur->xCoord, cur->yCoord, widthGrid);
-        if (curIdx != gridNodes.startIndex && curIdx != gridNodes.endIndex)
-            emit updatedScatterGridView(VISIT, curIdx);
-
-        std::this_thread::sleep_for(std::chrono::milliseconds(speedVisualization));
-
-        if (cur == goal) break;
-
-        for (Node* nb : cur->neighbours) {
-            if (nb->obstacle) continue;
-            float newCost = cur->localGoal + distance(cur, nb);
-            if (newCost < nb->localGoal) {
-                nb->parent = cur;
-                nb->localGoal = newCost;
-                open.push(nb);
-                int nbIdx = coordToIndex(nb->xCoord, nb->yCoord, widthGrid);
-                if (!nb->visited && nbIdx != gridNodes.endIndex)
-                    emit updatedScatterGridView(NEXT, nbIdx);
-            }
+    int curIdx = coordToIndex(cur->xCoord, cur->yCoord, widthGrid);
+    if (curIdx != gridNodes.startIndex && curIdx != gridNodes.endIndex)
+        updates.push_back({VISIT, curIdx});
+
+    if (cur == goal) {
+        finishSearch();
+        return;
+    }
+
+    // Step costs to all four neighbours at once, walls and the border masked out
+    float candidate[4];
+    int openDirs = terrain.candidates<FourConnected>(terrain.paddedIndex(curIdx), cur->localGoal, candidate);
+    for (int dir = 0; openDirs; ++dir, openDirs >>= 1) {
+        if (!(openDirs & 1)) continue;
+        int nbIdx = curIdx + terrain.offset(dir);
+        Node* nb = &gridNodes.touch(nbIdx);
+        SEARCH_STAT(searchStats.relaxations++);
+        if (candidate[dir] < nb->localGoal) {
+            SEARCH_STAT(searchStats.decreaseKeys += nb->localGoal < INFINITY);
+            nb->parent = cur;
+            nb->localGoal = candidate[dir];
+            open.push(nb);
+            SEARCH_STAT(searchStats.pushes++; searchStats.peakOpen = std::max(searchStats.peakOpen, open.size()));
+            if (!nb->visited && nbIdx != gridNodes.endIndex)
+                updates.push_back({NEXT, nbIdx});
         }
     }
+}
 
-    int pathLength = 0;
-    if (goal->parent != nullptr) {
-        std::vector<int> path;
+void DijkstraStepper::finishSearch()
+{
+    timer.enter(PHASE_RECONSTRUCT);
+    Node* goal = &gridNodes.touch(gridNodes.endIndex);
+    // A goal on the start has no parent but is found: the one-cell path
+    if (goal->parent != nullptr || gridNodes.endIndex == gridNodes.startIndex) {
         Node* p = goal;
         while (p != nullptr) {
-            path.insert(path.begin(), coordToIndex(p->xCoord, p->yCoord, widthGrid));
+            path.push_back(coordToIndex(p->xCoord, p->yCoord, widthGrid));
             p = p->parent;
         }
-        pathLength = path.size() - 1;
-
-        emit pathfindingSearchCompleted(visitedCount, pathLength);
-
-        // Visualize path
-        emit updatedLineGridView(QPointF(goal->xCoord, goal->yCoord), true, true);
-        for (size_t i = path.size() - 1; i > 0; --i) {
-            if (promise.isCanceled()) break;
-            int idx = path[i];
-            emit updatedScatterGridView(PATH, idx);
-            emit updatedLineGridView(QPointF(gridNodes.Nodes[idx].xCoord, gridNodes.Nodes[idx].yCoord), true, false);
-            std::this_thread::sleep_for(std::chrono::milliseconds(speedVisualization));
-        }
-        emit updatedLineGridView(QPointF(start->xCoord, start->yCoord), true, false);
-    } else {
-        emit pathfindingSearchCompleted(visitedCount, 0);
+        std::reverse(path.begin(), path.end());
+    }
+    SEARCH_STAT(searchStats.peakMemoryBytes = gridNodes.Nodes.capacity() * sizeof(Node) + terrain.memoryBytes()
+                                            + searchStats.peakOpen * sizeof(Node*) + path.capacity() * sizeof(int));
+    // Drawing the path is animation, not reconstruction
+    timer.finish();
+    if (path.empty()) {
+        phase = DONE;
+        return;
     }
+    // The path is drawn from the goal back to the start
+    pathCursor = path.size() - 1;
+    phase = TRACING;
+}
+
+void DijkstraStepper::drawNextPathCell(std::vector<StepUpdate>& updates)
+{
+    if (pathCursor == path.size() - 1)
+        updates.push_back({LINE, path.back(), true});
 
-    // Reset visited flags
-    for (Node& node : gridNodes.Nodes) {
-        node.visited = false;
-        node.nextUp = false;
+    if (pathCursor > 0) {
+        int idx = path[pathCursor];
+        updates.push_back({PATH, idx});
+        updates.push_back({LINE, idx});
+        pathCursor--;
     }
 
-    emit algorithmCompleted();
+    if (pathCursor == 0) {
+        if (path.size() > 1) updates.push_back({LINE, path.front()});
+        phase = DONE;
+    }
+}
+
+GridSnapshot snapshotFromGrid(const grid& g, int w, int h)
+{
+    GridSnapshot snapshot;
+    snapshot.width = w;
+    snapshot.height = h;
+    snapshot.startIndex = g.startIndex;
+    snapshot.endIndex = g.endIndex;
+    snapshot.obstacle.assign(w * h, 0);
+    for (int idx = 0; idx < w * h && idx < static_cast<int>(g.Nodes.size()); ++idx) {
+        snapshot.obstacle[idx] = g.Nodes[idx].obstacle ? 1 : 0;
+        if (g.Nodes[idx].cost != 1) {
+            if (snapshot.cost.empty()) snapshot.cost.assign(w * h, 1);
+            snapshot.cost[idx] = g.Nodes[idx].cost;
+        }
+    }
+    return snapshot;
 }
 
 QString PathAlgorithm::algorithmToString(ALGOS algo)
@@ -0,0 +1,101 @@
+#include "RaceView.h"
+#include <QVBoxLayout>
+#include <QtCharts/QChart>
+
+RaceView::RaceView(QWidget* parent) : QWidget(parent)
+{
+    setWindowTitle("Algorithm Race");
+    setWindowFlag(Qt::Window);
+    resize(900, 450);
+
+    splitter = new QSplitter(Qt::Horizontal, this);
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->addWidget(splitter);
+}
+
+void RaceView::startRace(const GridSnapshot& newSnapshot, const QStringList& runNames)
+{
+    snapshot = newSnapshot;
+    panels.clear();
+
+    // Deleting the widgets also deletes their charts and series
+    while (splitter->count() > 0)
+        delete splitter->widget(0);
+
+    for (const QString& name : runNames) {
+        QWidget* panelWidget = new QWidget(splitter);
+        QVBoxLayout* panelLayout = new QVBoxLayout(panelWidget);
+
+        Panel panel;
+        panel.name = name;
+        panel.label = new QLabel(name + ": running...", panelWidget);
+        panel.label->setAlignment(Qt::AlignCenter);
+        panel.label->setStyleSheet("font-weight: bold; color: #34ace0;");
+        panel.pathLine = new QLineSeries();
+
+        panelLayout->addWidget(panel.label);
+        panelLayout->addWidget(createPanelChart(panel.pathLine));
+        splitter->addWidget(panelWidget);
+
+        panels.append(panel);
+    }
+}
+
+QChartView* RaceView::createPanelChart(QLineSeries* pathLine)
+{
+    QChart* chart = new QChart();
+    chart->legend()->setVisible(false);
+
+    qreal markerSize = qMax(3, 360 / qMax(1, qMax(snapshot.width, snapshot.height)));
+
+    QScatterSeries* obstacles = new QScatterSeries();
+    obstacles->setMarkerShape(QScatterSeries::MarkerShapeRectangle);
+    obstacles->setMarkerSize(markerSize);
+    obstacles->setColor(QColor("#1e272e"));
+    obstacles->setBorderColor(QColorConstants::Black);
+    for (int idx = 0; idx < snapshot.cellCount(); ++idx) {
+        if (snapshot.obstacle[idx])
+            obstacles->append(QPointF(idx % snapshot.width + 1, idx / snapshot.width + 1));
+    }
+
+    QScatterSeries* endpoints = new QScatterSeries();
+    endpoints->setMarkerShape(QScatterSeries::MarkerShapeRectangle);
+    endpoints->setMarkerSize(markerSize);
+    endpoints->setColor(QColor("#0be881"));
+    endpoints->append(QPointF(snapshot.startIndex % snapshot.width + 1, snapshot.startIndex / snapshot.width + 1));
+    endpoints->append(QPointF(snapshot.endIndex % snapshot.width + 1, snapshot.endIndex / snapshot.width + 1));
+
+    pathLine->setColor(QColor("#ff5252"));
+
+    chart->addSeries(obstacles);
+    chart->addSeries(endpoints);
+    chart->addSeries(pathLine);
+    chart->createDefaultAxes();
+    chart->axes(Qt::Horizontal).first()->setRange(qreal(0.4), qreal(snapshot.width + 0.5));
+    chart->axes(Qt::Vertical).first()->setRange(qreal(0.4), qreal(snapshot.height + 0.5));
+
+    QChartView* view = new QChartView(chart);
+    view->setRenderHint(QPainter::Antialiasing);
+    return view;
+}
+
+void RaceView::showResult(int runIndex, const SearchResult& result)
+{
+    if (runIndex < 0 || runIndex >= panels.size()) return;
+    Panel& panel = panels[runIndex];
+
+    QList<QPointF> points;
+    points.reserve(result.path.size());
+    for (int idx : result.path)
+        points.append(QPointF(idx % snapshot.width + 1, idx / snapshot.width + 1));
+    panel.pathLine->replace(points);
+
+    QString text = QString("%1: %2 ms, %3 expanded, path %4")
+                   .arg(panel.name)
+                   .arg(result.timeElapsedNs / 1e6, 0, 'f', 3)
+                   .arg(result.nodesVisited)
+                   .arg(result.pathLength);
+    if (result.lineOfSightChecks > 0)
+        text += QString(" (length %1, %2 LOS checks)").arg(result.pathCost, 0, 'f', 1).arg(result.lineOfSightChecks);
+    panel.label->setText(text);
+}
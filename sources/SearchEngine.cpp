@@ -0,0 +1,224 @@
+#include "SearchEngine.h"
+#include "SearchKernel.h"
+#include "BitParallelBfs.h"
+#include "ThetaStar.h"
+#include "ContractionHierarchy.h"
+#include "HierarchicalPlanner.h"
+#include "LandmarkPlanner.h"
+#include "LocalSearch.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <functional>
+
+uint64_t nextSnapshotRevision()
+{
+    static std::atomic<uint64_t> counter{0};
+    return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+GridSnapshot withLayout(const GridSnapshot& snapshot, CELLLAYOUTS layout)
+{
+    if (snapshot.layout == layout) return snapshot;
+    GridSnapshot converted;
+    converted.width = snapshot.width;
+    converted.height = snapshot.height;
+    converted.layout = layout;
+    converted.obstacle.resize(snapshot.obstacle.size());
+    converted.cost.resize(snapshot.cost.size());
+    for (int y = 0; y < snapshot.height; ++y) {
+        for (int x = 0; x < snapshot.width; ++x) {
+            const int from = snapshot.cellAt(x, y);
+            const int to = converted.cellAt(x, y);
+            converted.obstacle[to] = snapshot.obstacle[from];
+            if (!snapshot.cost.empty()) converted.cost[to] = snapshot.cost[from];
+        }
+    }
+    int x, y;
+    snapshot.cellCoords(snapshot.startIndex, x, y);
+    converted.startIndex = converted.cellAt(x, y);
+    snapshot.cellCoords(snapshot.endIndex, x, y);
+    converted.endIndex = converted.cellAt(x, y);
+    return converted;
+}
+
+void SearchStats::add(const SearchStats& other)
+{
+    pushes += other.pushes;
+    pops += other.pops;
+    stalePops += other.stalePops;
+    relaxations += other.relaxations;
+    decreaseKeys += other.decreaseKeys;
+    peakOpen = std::max(peakOpen, other.peakOpen);
+    peakMemoryBytes = std::max(peakMemoryBytes, other.peakMemoryBytes);
+}
+
+void SearchScratch::prepare(int cellCount)
+{
+    distance.assign(cellCount, INFINITY);
+    parent.assign(cellCount, -1);
+    closed.assign(cellCount, 0);
+    open.clear();
+    cleanFor = nullptr;
+}
+
+void SearchScratch::beginQuery(int cellCount)
+{
+    const size_t cells = static_cast<size_t>(cellCount);
+    if (stamp.size() != cells || distance.size() != cells || parent.size() != cells || closed.size() != cells) {
+        // Entries left by prepare() or another grid are stale once stamps are 0
+        distance.resize(cells);
+        parent.resize(cells);
+        closed.resize(cells);
+        stamp.assign(cells, 0);
+        epoch = 0;
+    }
+    if (++epoch == 0) {
+        std::fill(stamp.begin(), stamp.end(), 0u);
+        epoch = 1;
+    }
+    open.clear();
+    cleanFor = nullptr;
+}
+
+size_t SearchScratch::memoryBytes() const
+{
+    return distance.capacity() * sizeof(float)
+         + parent.capacity() * sizeof(int)
+         + closed.capacity() * sizeof(uint8_t)
+         + stamp.capacity() * sizeof(uint32_t)
+         + (open.capacity() + backwardOpen.capacity()) * sizeof(std::pair<float, int>)
+         + terrain.memoryBytes()
+         + bits.capacity() * sizeof(uint64_t)
+         + (cells.capacity() + nextCells.capacity() + stamps.capacity()) * sizeof(int)
+         + (regionDistance.capacity() + regionParent.capacity() + regionQueue.capacity()) * sizeof(int)
+         + sparse.reservedBytes()
+         + lineOfSight.memoryBytes();
+}
+
+void SearchScratch::takePath(std::vector<int>& out)
+{
+    out.swap(path);
+    out.clear();
+}
+
+void tracePath(const std::vector<int>& parent, int goal, std::vector<int>& path)
+{
+    size_t length = 0;
+    for (int p = goal; p != -1; p = parent[p])
+        length++;
+    path.resize(length);
+    for (int p = goal; p != -1; p = parent[p])
+        path[--length] = p;
+}
+
+// -----------------------------------------------------------------
+// Search context
+// -----------------------------------------------------------------
+void SearchContext::recycle()
+{
+    // Keep the larger of the two buffers, the other one is dropped
+    if (last.path.capacity() > buffers.path.capacity())
+        buffers.path.swap(last.path);
+    last.path.clear();
+}
+
+const SearchResult& SearchContext::run(const SolverEntry& solver, const GridSnapshot& snapshot,
+                                       int startIndex, int endIndex)
+{
+    recycle();
+    if (snapshot.layout == LAYOUT_ROW_MAJOR || solver.anyLayout) {
+        last = solver.run(snapshot, startIndex, endIndex, buffers);
+        return last;
+    }
+
+    if (rowMajorOf != snapshot.revision) {
+        rowMajor = withLayout(snapshot, LAYOUT_ROW_MAJOR);
+        rowMajorOf = snapshot.revision;
+    }
+    int x, y;
+    snapshot.cellCoords(startIndex, x, y);
+    const int start = rowMajor.cellAt(x, y);
+    snapshot.cellCoords(endIndex, x, y);
+    const int goal = rowMajor.cellAt(x, y);
+    last = solver.run(rowMajor, start, goal, buffers);
+    for (int& cell : last.path) {
+        rowMajor.cellCoords(cell, x, y);
+        cell = snapshot.cellAt(x, y);
+    }
+    return last;
+}
+
+const SearchResult& SearchContext::query(const PreparedSolver& solver, int startIndex, int endIndex)
+{
+    recycle();
+    last = solver.query(startIndex, endIndex, buffers);
+    return last;
+}
+
+// -----------------------------------------------------------------
+// Headless solvers, all instantiations of the search kernel
+// -----------------------------------------------------------------
+SearchResult dijkstraSearch(const GridSnapshot& snapshot, int start, int goal, SearchScratch& scratch)
+{
+    return kernelSearch(KernelConfig(), snapshot, start, goal, scratch);
+}
+
+static SearchResult astarSearch(const GridSnapshot& snapshot, int start, int goal, SearchScratch& scratch)
+{
+    KernelConfig config;
+    config.heuristic = HEURISTIC_MANHATTAN;
+    return kernelSearch(config, snapshot, start, goal, scratch);
+}
+
+static SearchResult dijkstraSearch8(const GridSnapshot& snapshot, int start, int goal, SearchScratch& scratch)
+{
+    KernelConfig config;
+    config.connectivity = 8;
+    return kernelSearch(config, snapshot, start, goal, scratch);
+}
+
+static SearchResult astarSearch8(const GridSnapshot& snapshot, int start, int goal, SearchScratch& scratch)
+{
+    KernelConfig config;
+    config.connectivity = 8;
+    config.heuristic = HEURISTIC_OCTILE;
+    return kernelSearch(config, snapshot, start, goal, scratch);
+}
+
+const std::vector<SolverEntry>& solverRegistry()
+{
+    static const std::vector<SolverEntry> registry = {
+        {"Dijkstra", &dijkstraSearch, true},
+        {"A*", &astarSearch, true},
+        {"Dijkstra 8-way", &dijkstraSearch8, true},
+        {"A* 8-way", &astarSearch8, true},
+        {"BFS (bit-parallel)", &bitParallelBfs},
+        {"Theta*", &thetaStarSearch},
+        {"Lazy Theta*", &lazyThetaStarSearch},
+        {"Local A*", &localAStarSearch, true},
+    };
+    return registry;
+}
+
+const SolverEntry* findSolver(const std::string& name)
+{
+    for (const SolverEntry& entry : solverRegistry()) {
+        if (entry.name == name) return &entry;
+    }
+    return nullptr;
+}
+
+std::vector<std::string> preparedSolverNames()
+{
+    return {"HPA*", "ALT", "CH"};
+}
+
+std::unique_ptr<PreparedSolver> createPreparedSolver(const std::string& name)
+{
+    if (name == "HPA*") return std::make_unique<HierarchicalPlanner>();
+    if (name == "ALT") return std::make_unique<LandmarkPlanner>();
+    if (name == "CH") return std::make_unique<ContractionHierarchy>();
+    return nullptr;
+}
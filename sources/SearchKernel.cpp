@@ -0,0 +1,230 @@
+#include "SearchKernel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+
+namespace {
+
+// Cost policies: build the padded plane once per search, then write the
+// candidate distance of every neighbour of the cell at padded entry pad and
+// return the ones that can be entered
+struct UnitCost
+{
+    static void build(const GridSnapshot& snapshot, TerrainCosts& terrain) { terrain.buildBytes(snapshot, true); }
+
+    template <class Dirs>
+    static int candidates(const TerrainCosts& terrain, int pad, float distance, float* out)
+    {
+        const uint8_t* p = terrain.bytes() + pad;
+        int open = 0;
+        for (int dir = 0; dir < Dirs::count; ++dir) {
+            out[dir] = distance + Dirs::multiplier[dir];
+            open |= (p[terrain.paddedOffset(dir)] != 0) << dir;
+        }
+        return open;
+    }
+};
+
+struct ByteCost
+{
+    static void build(const GridSnapshot& snapshot, TerrainCosts& terrain) { terrain.buildBytes(snapshot, false); }
+
+    template <class Dirs>
+    static int candidates(const TerrainCosts& terrain, int pad, float distance, float* out)
+    {
+        const uint8_t* p = terrain.bytes() + pad;
+        int open = 0;
+        for (int dir = 0; dir < Dirs::count; ++dir) {
+            const uint8_t cost = p[terrain.paddedOffset(dir)];
+            out[dir] = distance + cost * Dirs::multiplier[dir];
+            open |= (cost != 0) << dir;
+        }
+        return open;
+    }
+};
+
+struct FloatCost
+{
+    static void build(const GridSnapshot& snapshot, TerrainCosts& terrain) { terrain.build(snapshot); }
+
+    template <class Dirs>
+    static int candidates(const TerrainCosts& terrain, int pad, float distance, float* out)
+    {
+        return terrain.candidates<Dirs>(pad, distance, out);
+    }
+};
+
+// Heuristics on the absolute offsets to the goal. Terrain costs are at
+// least 1, so step counts stay lower bounds.
+struct NoHeuristic
+{
+    static float estimate(int, int) { return 0.0f; }
+};
+
+struct ManhattanHeuristic
+{
+    static float estimate(int dx, int dy) { return static_cast<float>(dx + dy); }
+};
+
+struct OctileHeuristic
+{
+    static float estimate(int dx, int dy)
+    {
+        return static_cast<float>(std::max(dx, dy)) + 0.41421356f * std::min(dx, dy);
+    }
+};
+
+// Cell layouts. Row-major cells step to a neighbour by a fixed offset and
+// sit on the padded planes at paddedIndex(cell); tiled cells go through
+// their coordinates for both.
+struct RowMajorCells
+{
+    static constexpr bool tiled = false;
+    typedef RowMajorLayout Layout;
+};
+
+struct TiledCells
+{
+    static constexpr bool tiled = true;
+    typedef TiledLayout Layout;
+};
+
+template <class Dirs, class Cost, class Heuristic, class Cells>
+SearchResult search(const GridSnapshot& snapshot, int start, int goal, SearchScratch& scratch)
+{
+    PhaseTimer timer;
+    SearchResult result;
+    [[maybe_unused]] SearchStats& stats = result.stats;
+
+    const typename Cells::Layout cells = {snapshot.width, snapshot.height};
+    int goalX, goalY;
+    cells.coords(goal, goalX, goalY);
+    auto estimateAt = [&](int x, int y) {
+        return Heuristic::estimate(std::abs(x - goalX), std::abs(y - goalY));
+    };
+    auto estimate = [&](int cell) {
+        int x, y;
+        cells.coords(cell, x, y);
+        return estimateAt(x, y);
+    };
+
+    scratch.beginQuery(snapshot.cellCount());
+    Cost::build(snapshot, scratch.terrain);
+    scratch.touch(start);
+    scratch.distance[start] = 0.0f;
+    scratch.open.push_back({estimate(start), start});
+    SEARCH_STAT(stats.pushes = 1; stats.peakOpen = 1);
+    timer.enter(PHASE_SEARCH);
+
+    auto heapCmp = std::greater<std::pair<float, int>>();
+
+    while (!scratch.open.empty()) {
+        std::pop_heap(scratch.open.begin(), scratch.open.end(), heapCmp);
+        int cur = scratch.open.back().second;
+        scratch.open.pop_back();
+        SEARCH_STAT(stats.pops++);
+
+        if (scratch.closed[cur]) {
+            SEARCH_STAT(stats.stalePops++);
+            continue;
+        }
+        scratch.closed[cur] = 1;
+        result.nodesVisited++;
+
+        if (cur == goal) break;
+
+        int x = 0, y = 0;
+        int pad;
+        if constexpr (Cells::tiled) {
+            cells.coords(cur, x, y);
+            pad = scratch.terrain.paddedIndex(x, y);
+        } else {
+            pad = scratch.terrain.paddedIndex(cur);
+        }
+
+        float candidate[Dirs::count];
+        int open = withoutCutCorners<Dirs>(
+            Cost::template candidates<Dirs>(scratch.terrain, pad, scratch.distance[cur], candidate));
+        for (int dir = 0; open; ++dir, open >>= 1) {
+            if (!(open & 1)) continue;
+            int nb;
+            if constexpr (Cells::tiled)
+                nb = cells.index(x + Dirs::dx[dir], y + Dirs::dy[dir]);
+            else
+                nb = cur + scratch.terrain.offset(dir);
+            SEARCH_STAT(stats.relaxations++);
+            scratch.touch(nb);
+            if (candidate[dir] < scratch.distance[nb]) {
+                SEARCH_STAT(stats.decreaseKeys += scratch.distance[nb] < INFINITY);
+                scratch.distance[nb] = candidate[dir];
+                scratch.parent[nb] = cur;
+                float h;
+                if constexpr (Cells::tiled)
+                    h = estimateAt(x + Dirs::dx[dir], y + Dirs::dy[dir]);
+                else
+                    h = estimate(nb);
+                scratch.open.push_back({candidate[dir] + h, nb});
+                std::push_heap(scratch.open.begin(), scratch.open.end(), heapCmp);
+                SEARCH_STAT(stats.pushes++; stats.peakOpen = std::max(stats.peakOpen, scratch.open.size()));
+            }
+        }
+    }
+
+    timer.enter(PHASE_RECONSTRUCT);
+    if (scratch.touched(goal) && (goal == start || scratch.parent[goal] != -1)) {
+        scratch.takePath(result.path);
+        tracePath(scratch.parent, goal, result.path);
+        result.pathLength = static_cast<int>(result.path.size()) - 1;
+        result.pathCost = scratch.distance[goal];
+    }
+    result.timing = timer.finish();
+    result.timeElapsedNs = result.timing.totalNs();
+
+    result.memoryBytes = scratch.memoryBytes() + result.path.capacity() * sizeof(int);
+    SEARCH_STAT(stats.peakMemoryBytes = result.memoryBytes);
+    return result;
+}
+
+typedef SearchResult (*KernelFunction)(const GridSnapshot&, int, int, SearchScratch&);
+
+template <class Dirs, class Cost, class Heuristic>
+KernelFunction withCells(CELLLAYOUTS layout)
+{
+    return layout == LAYOUT_TILED ? &search<Dirs, Cost, Heuristic, TiledCells>
+                                  : &search<Dirs, Cost, Heuristic, RowMajorCells>;
+}
+
+template <class Dirs, class Cost>
+KernelFunction withHeuristic(HEURISTICS heuristic, CELLLAYOUTS layout)
+{
+    switch (heuristic) {
+    case HEURISTIC_MANHATTAN: return withCells<Dirs, Cost, ManhattanHeuristic>(layout);
+    case HEURISTIC_OCTILE:    return withCells<Dirs, Cost, OctileHeuristic>(layout);
+    default:                  return withCells<Dirs, Cost, NoHeuristic>(layout);
+    }
+}
+
+template <class Dirs>
+KernelFunction withCost(COSTTYPES cost, HEURISTICS heuristic, CELLLAYOUTS layout)
+{
+    switch (cost) {
+    case COST_BYTE:  return withHeuristic<Dirs, ByteCost>(heuristic, layout);
+    case COST_FLOAT: return withHeuristic<Dirs, FloatCost>(heuristic, layout);
+    default:         return withHeuristic<Dirs, UnitCost>(heuristic, layout);
+    }
+}
+
+} // namespace
+
+SearchResult kernelSearch(const KernelConfig& config, const GridSnapshot& snapshot, int start, int goal,
+                          SearchScratch& scratch)
+{
+    COSTTYPES cost = config.cost;
+    if (cost == COST_AUTO) cost = snapshot.cost.empty() ? COST_UNIT : COST_FLOAT;
+
+    KernelFunction kernel = config.connectivity == 8
+                                ? withCost<EightConnected>(cost, config.heuristic, snapshot.layout)
+                                : withCost<FourConnected>(cost, config.heuristic, snapshot.layout);
+    return kernel(snapshot, start, goal, scratch);
+}
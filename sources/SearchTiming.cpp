@@ -0,0 +1,166 @@
+#include "SearchTiming.h"
+#include <cstdint>
+#include <cstring>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#if defined(__linux__)
+// The four hardware events as one group, so they are scheduled together and
+// read with a single read() call
+class CounterGroup
+{
+public:
+    CounterGroup()
+    {
+        const uint64_t events[4] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                    PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+        for (int i = 0; i < 4; ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = events[i];
+            attr.read_format = PERF_FORMAT_GROUP;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.disabled = i == 0;     // the leader starts the whole group below
+            fds[i] = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, i == 0 ? -1 : fds[0], 0));
+            if (fds[i] < 0) {
+                close(i);
+                return;
+            }
+        }
+        ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        opened = true;
+    }
+
+    ~CounterGroup()
+    {
+        if (opened) close(4);
+    }
+
+    HardwareCounters read() const
+    {
+        HardwareCounters counters;
+        if (!opened) return counters;
+        struct {
+            uint64_t count;
+            uint64_t values[4];
+        } data;
+        if (::read(fds[0], &data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data.count != 4)
+            return counters;
+        counters.valid = true;
+        counters.cycles = static_cast<long long>(data.values[0]);
+        counters.instructions = static_cast<long long>(data.values[1]);
+        counters.cacheMisses = static_cast<long long>(data.values[2]);
+        counters.branchMisses = static_cast<long long>(data.values[3]);
+        return counters;
+    }
+
+private:
+    void close(int count)
+    {
+        for (int i = 0; i < count; ++i)
+            ::close(fds[i]);
+        opened = false;
+    }
+
+    int fds[4] = {-1, -1, -1, -1};
+    bool opened = false;
+};
+#endif
+
+} // namespace
+
+void HardwareCounters::add(const HardwareCounters& other)
+{
+    if (!other.valid) return;
+    valid = true;
+    cycles += other.cycles;
+    instructions += other.instructions;
+    cacheMisses += other.cacheMisses;
+    branchMisses += other.branchMisses;
+}
+
+HardwareCounters readHardwareCounters()
+{
+#if defined(__linux__)
+    thread_local CounterGroup group;
+    return group.read();
+#else
+    return HardwareCounters();
+#endif
+}
+
+void SearchTiming::add(const SearchTiming& other)
+{
+    setupNs += other.setupNs;
+    searchNs += other.searchNs;
+    reconstructNs += other.reconstructNs;
+    hardware.add(other.hardware);
+}
+
+// -----------------------------------------------------------------
+// PhaseTimer
+// -----------------------------------------------------------------
+PhaseTimer::PhaseTimer(SEARCHPHASES phase)
+{
+    resume(phase);
+}
+
+void PhaseTimer::enter(SEARCHPHASES phase)
+{
+    stop();
+    resume(phase);
+}
+
+void PhaseTimer::pause()
+{
+    stop();
+}
+
+void PhaseTimer::resume(SEARCHPHASES phase)
+{
+    if (running) stop();
+    current = phase;
+    running = true;
+    countersSince = readHardwareCounters();
+    since = std::chrono::steady_clock::now();
+}
+
+const SearchTiming& PhaseTimer::finish()
+{
+    stop();
+    return totals;
+}
+
+void PhaseTimer::stop()
+{
+    if (!running) return;
+    const long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - since).count();
+    const HardwareCounters now = readHardwareCounters();
+    running = false;
+
+    switch (current) {
+    case PHASE_SETUP:       totals.setupNs += ns; break;
+    case PHASE_SEARCH:      totals.searchNs += ns; break;
+    case PHASE_RECONSTRUCT: totals.reconstructNs += ns; break;
+    }
+
+    if (now.valid && countersSince.valid) {
+        HardwareCounters delta;
+        delta.valid = true;
+        delta.cycles = now.cycles - countersSince.cycles;
+        delta.instructions = now.instructions - countersSince.instructions;
+        delta.cacheMisses = now.cacheMisses - countersSince.cacheMisses;
+        delta.branchMisses = now.branchMisses - countersSince.branchMisses;
+        totals.hardware.add(delta);
+    }
+}
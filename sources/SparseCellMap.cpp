@@ -0,0 +1,179 @@
+#include "SparseCellMap.h"
+#include <new>
+#include <utility>
+
+namespace {
+
+// Smallest class whose block holds bytes: block size 16 << class
+int sizeClass(size_t bytes)
+{
+    int index = 0;
+    while ((size_t(16) << index) < bytes) ++index;
+    return index;
+}
+
+} // namespace
+
+BlockPool::BlockPool(BlockPool&& other) noexcept
+    : reserved(other.reserved)
+{
+    for (int i = 0; i < kClasses; ++i) {
+        freeLists[i] = other.freeLists[i];
+        other.freeLists[i] = nullptr;
+    }
+    other.reserved = 0;
+}
+
+BlockPool& BlockPool::operator=(BlockPool&& other) noexcept
+{
+    if (this != &other) {
+        freeAll();
+        for (int i = 0; i < kClasses; ++i) {
+            freeLists[i] = other.freeLists[i];
+            other.freeLists[i] = nullptr;
+        }
+        reserved = other.reserved;
+        other.reserved = 0;
+    }
+    return *this;
+}
+
+BlockPool::~BlockPool()
+{
+    freeAll();
+}
+
+void BlockPool::freeAll()
+{
+    for (int i = 0; i < kClasses; ++i) {
+        while (freeLists[i]) {
+            void* next = *static_cast<void**>(freeLists[i]);
+            ::operator delete(freeLists[i]);
+            freeLists[i] = next;
+        }
+    }
+    reserved = 0;
+}
+
+void* BlockPool::allocate(size_t bytes)
+{
+    const int slot = sizeClass(bytes);
+    if (void* block = freeLists[slot]) {
+        freeLists[slot] = *static_cast<void**>(block);
+        return block;
+    }
+    reserved += size_t(16) << slot;
+    return ::operator new(size_t(16) << slot);
+}
+
+void BlockPool::release(void* block, size_t bytes)
+{
+    if (!block) return;
+    const int slot = sizeClass(bytes);
+    *static_cast<void**>(block) = freeLists[slot];
+    freeLists[slot] = block;
+}
+
+SparseCellMap::SparseCellMap(SparseCellMap&& other) noexcept
+    : pool(std::move(other.pool)), slots(other.slots), mask(other.mask), shift(other.shift), count(other.count)
+{
+    other.slots = nullptr;
+    other.mask = 0;
+    other.shift = 32;
+    other.count = 0;
+}
+
+SparseCellMap& SparseCellMap::operator=(const SparseCellMap& other)
+{
+    // Like the copy constructor: the contents of a query are not carried over
+    if (this != &other) {
+        pool.release(slots, memoryBytes());
+        slots = nullptr;
+        mask = 0;
+        shift = 32;
+        count = 0;
+    }
+    return *this;
+}
+
+SparseCellMap& SparseCellMap::operator=(SparseCellMap&& other) noexcept
+{
+    if (this != &other) {
+        pool.release(slots, memoryBytes());
+        pool = std::move(other.pool);
+        slots = other.slots;
+        mask = other.mask;
+        shift = other.shift;
+        count = other.count;
+        other.slots = nullptr;
+        other.mask = 0;
+        other.shift = 32;
+        other.count = 0;
+    }
+    return *this;
+}
+
+SparseCellMap::~SparseCellMap()
+{
+    pool.release(slots, memoryBytes());
+}
+
+void SparseCellMap::clear(size_t expectedCells)
+{
+    size_t slotCount = 16;
+    while (slotCount < 2 * expectedCells) slotCount <<= 1;
+    if (slots && capacity() == slotCount) {
+        for (size_t i = 0; i <= mask; ++i) slots[i].cell = -1;
+    } else {
+        pool.release(slots, memoryBytes());
+        slots = static_cast<Slot*>(pool.allocate(slotCount * sizeof(Slot)));
+        mask = slotCount - 1;
+        shift = 32;
+        for (size_t size = slotCount; size > 1; size >>= 1) --shift;
+        for (size_t i = 0; i < slotCount; ++i) slots[i].cell = -1;
+    }
+    count = 0;
+}
+
+const SparseCellMap::Slot* SparseCellMap::find(int cell) const
+{
+    if (!slots) return nullptr;
+    for (size_t i = home(cell);; i = (i + 1) & mask) {
+        if (slots[i].cell == cell) return &slots[i];
+        if (slots[i].cell < 0) return nullptr;
+    }
+}
+
+SparseCellMap::Slot& SparseCellMap::insert(int cell)
+{
+    if (!slots) clear();
+    for (size_t i = home(cell);; i = (i + 1) & mask) {
+        if (slots[i].cell == cell) return slots[i];
+        if (slots[i].cell < 0) {
+            if (2 * (count + 1) > capacity()) {
+                resize(2 * capacity());
+                return insert(cell);
+            }
+            count++;
+            slots[i] = {cell, -1, INFINITY, 0};
+            return slots[i];
+        }
+    }
+}
+
+void SparseCellMap::resize(size_t slotCount)
+{
+    Slot* old = slots;
+    const size_t oldCount = capacity();
+    slots = static_cast<Slot*>(pool.allocate(slotCount * sizeof(Slot)));
+    mask = slotCount - 1;
+    --shift;
+    for (size_t i = 0; i < slotCount; ++i) slots[i].cell = -1;
+    for (size_t j = 0; j < oldCount; ++j) {
+        if (old[j].cell < 0) continue;
+        size_t i = home(old[j].cell);
+        while (slots[i].cell >= 0) i = (i + 1) & mask;
+        slots[i] = old[j];
+    }
+    pool.release(old, oldCount * sizeof(Slot));
+}
@@ -0,0 +1,57 @@
+#include "TerrainCost.h"
+#include "SearchEngine.h"
+
+void TerrainCosts::setDimensions(const GridSnapshot& snapshot)
+{
+    width = snapshot.width;
+    stride = snapshot.width + 2;
+    for (int dir = 0; dir < EightConnected::count; ++dir) {
+        cellOffsets[dir] = EightConnected::dx[dir] + EightConnected::dy[dir] * width;
+        padOffsets[dir] = EightConnected::dx[dir] + EightConnected::dy[dir] * stride;
+    }
+}
+
+void TerrainCosts::build(const GridSnapshot& snapshot)
+{
+    setDimensions(snapshot);
+    const int w = snapshot.width;
+    const int h = snapshot.height;
+    // The spare entry lets candidates() load four floats from the last row
+    const size_t size = static_cast<size_t>(stride) * (h + 2) + 1;
+    if (floatRevision == snapshot.revision && enter.size() == size) return;
+    floatRevision = snapshot.revision;
+    enter.assign(size, INFINITY);
+    for (int y = 0; y < h; ++y) {
+        float* row = &enter[static_cast<size_t>(y + 1) * stride + 1];
+        for (int x = 0; x < w; ++x) {
+            const int cell = snapshot.cellAt(x, y);
+            if (!snapshot.obstacle[cell]) row[x] = snapshot.costAt(cell);
+        }
+    }
+}
+
+void TerrainCosts::buildBytes(const GridSnapshot& snapshot, bool unit)
+{
+    setDimensions(snapshot);
+    const int w = snapshot.width;
+    const int h = snapshot.height;
+    if (bytesRevision == snapshot.revision && bytesUnit == unit
+        && enterBytes.size() == static_cast<size_t>(stride) * (h + 2))
+        return;
+    bytesRevision = snapshot.revision;
+    bytesUnit = unit;
+    enterBytes.assign(static_cast<size_t>(stride) * (h + 2), 0);
+    for (int y = 0; y < h; ++y) {
+        uint8_t* row = &enterBytes[static_cast<size_t>(y + 1) * stride + 1];
+        for (int x = 0; x < w; ++x) {
+            const int cell = snapshot.cellAt(x, y);
+            if (!snapshot.obstacle[cell])
+                row[x] = (unit || snapshot.cost.empty()) ? 1 : snapshot.cost[cell];
+        }
+    }
+}
+
+size_t TerrainCosts::memoryBytes() const
+{
+    return enter.capacity() * sizeof(float) + enterBytes.capacity();
+}
@@ -0,0 +1,130 @@
+#include "ThetaStar.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace {
+
+float euclidean(int a, int b, int w)
+{
+    const float dx = static_cast<float>(a % w - b % w);
+    const float dy = static_cast<float>(a / w - b / w);
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+// Free 8-connected neighbours of cell, without cutting corners
+int openDirections(const TerrainCosts& terrain, int cell)
+{
+    const uint8_t* p = terrain.bytes() + terrain.paddedIndex(cell);
+    int open = 0;
+    for (int dir = 0; dir < EightConnected::count; ++dir)
+        open |= (p[terrain.paddedOffset(dir)] != 0) << dir;
+    return withoutCutCorners<EightConnected>(open);
+}
+
+template <bool Lazy>
+SearchResult anyAngleSearch(const GridSnapshot& snapshot, int start, int goal, SearchScratch& scratch)
+{
+    PhaseTimer timer;
+    SearchResult result;
+    [[maybe_unused]] SearchStats& stats = result.stats;
+
+    const int w = snapshot.width;
+    std::vector<float>& g = scratch.distance;
+    std::vector<int>& parent = scratch.parent;
+    LineOfSight& lineOfSight = scratch.lineOfSight;
+
+    scratch.beginQuery(snapshot.cellCount());
+    scratch.terrain.buildBytes(snapshot, true);
+    lineOfSight.begin(snapshot);
+    scratch.touch(start);
+    g[start] = 0.0f;
+    scratch.open.push_back({euclidean(start, goal, w), start});
+    SEARCH_STAT(stats.pushes = 1; stats.peakOpen = 1);
+    timer.enter(PHASE_SEARCH);
+
+    auto heapCmp = std::greater<std::pair<float, int>>();
+
+    while (!scratch.open.empty()) {
+        std::pop_heap(scratch.open.begin(), scratch.open.end(), heapCmp);
+        int cur = scratch.open.back().second;
+        scratch.open.pop_back();
+        SEARCH_STAT(stats.pops++);
+
+        if (scratch.closed[cur]) {
+            SEARCH_STAT(stats.stalePops++);
+            continue;
+        }
+
+        if (Lazy && parent[cur] != -1 && !lineOfSight.visible(parent[cur], cur)) {
+            // The assumed shortcut is blocked: come from the best expanded neighbour
+            float best = INFINITY;
+            for (int open = openDirections(scratch.terrain, cur), dir = 0; open; ++dir, open >>= 1) {
+                int nb = cur + scratch.terrain.offset(dir);
+                if (!(open & 1) || !scratch.touched(nb) || !scratch.closed[nb]) continue;
+                float cost = g[nb] + EightConnected::multiplier[dir];
+                if (cost < best) {
+                    best = cost;
+                    parent[cur] = nb;
+                }
+            }
+            g[cur] = best;
+        }
+
+        scratch.closed[cur] = 1;
+        result.nodesVisited++;
+
+        if (cur == goal) break;
+
+        const int grandparent = parent[cur];
+        for (int open = openDirections(scratch.terrain, cur), dir = 0; open; ++dir, open >>= 1) {
+            int nb = cur + scratch.terrain.offset(dir);
+            if (!(open & 1)) continue;
+            scratch.touch(nb);
+            if (scratch.closed[nb]) continue;
+            SEARCH_STAT(stats.relaxations++);
+
+            int via = cur;
+            float cost = g[cur] + EightConnected::multiplier[dir];
+            if (grandparent != -1 && (Lazy || lineOfSight.visible(grandparent, nb))) {
+                via = grandparent;
+                cost = g[grandparent] + euclidean(grandparent, nb, w);
+            }
+            if (cost < g[nb]) {
+                SEARCH_STAT(stats.decreaseKeys += g[nb] < INFINITY);
+                g[nb] = cost;
+                parent[nb] = via;
+                scratch.open.push_back({cost + euclidean(nb, goal, w), nb});
+                std::push_heap(scratch.open.begin(), scratch.open.end(), heapCmp);
+                SEARCH_STAT(stats.pushes++; stats.peakOpen = std::max(stats.peakOpen, scratch.open.size()));
+            }
+        }
+    }
+
+    timer.enter(PHASE_RECONSTRUCT);
+    if (scratch.touched(goal) && scratch.closed[goal] && (goal == start || parent[goal] != -1)) {
+        scratch.takePath(result.path);
+        tracePath(parent, goal, result.path);
+        result.pathLength = static_cast<int>(result.path.size()) - 1;
+        result.pathCost = g[goal];
+    }
+    result.timing = timer.finish();
+    result.timeElapsedNs = result.timing.totalNs();
+
+    result.lineOfSightChecks = lineOfSight.calls();
+    result.memoryBytes = scratch.memoryBytes() + result.path.capacity() * sizeof(int);
+    SEARCH_STAT(stats.peakMemoryBytes = result.memoryBytes);
+    return result;
+}
+
+} // namespace
+
+SearchResult thetaStarSearch(const GridSnapshot& snapshot, int start, int goal, SearchScratch& scratch)
+{
+    return anyAngleSearch<false>(snapshot, start, goal, scratch);
+}
+
+SearchResult lazyThetaStarSearch(const GridSnapshot& snapshot, int start, int goal, SearchScratch& scratch)
+{
+    return anyAngleSearch<true>(snapshot, start, goal, scratch);
+}
@@ -0,0 +1,251 @@
+#include "TraceEvents.h"
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <mutex>
+
+std::atomic<bool> traceRecording{false};
+
+namespace {
+
+struct TraceEvent
+{
+    const char* name;
+    const char* category;
+    int64_t startNs;
+    int64_t durationNs;
+};
+
+struct TraceChunk
+{
+    static constexpr int capacity = 4096;
+    TraceEvent events[capacity];
+    std::atomic<int> count{0};              // written by the owner, release
+    std::atomic<TraceChunk*> next{nullptr};
+    TraceChunk* nextRetired = nullptr;      // first chunk of the next retired chain
+};
+
+// Past the cap a thread drops its events until the next clearTrace().
+const int kMaxChunksPerThread = 256;
+
+struct ThreadBuffer
+{
+    int id = 0;
+    std::atomic<const char*> name{nullptr};
+    std::atomic<TraceChunk*> head{new TraceChunk};
+    TraceChunk* tail = head.load();         // owner only
+    int chunkCount = 1;                     // owner only
+    unsigned epoch = 0;                     // owner only: traceEpoch of the chunks
+    std::atomic<long long> dropped{0};
+    std::atomic<TraceChunk*> retired{nullptr};
+    std::atomic<bool> finished{false};      // the owner thread has exited
+    ThreadBuffer* nextBuffer = nullptr;     // set before the buffer is published
+};
+
+// Every buffer ever created, newest first. Buffers outlive their threads so
+// events of finished pool threads can still be exported.
+std::atomic<ThreadBuffer*> allBuffers{nullptr};
+std::atomic<int> threadCount{0};
+std::atomic<int64_t> clearedAtNs{LLONG_MIN};
+
+// Bumped by clearTrace(). A writer that sees a new epoch starts a fresh chain
+// and retires the old one; retired chains are freed under exportMutex, which
+// every export holds, so no exporter is still reading them.
+std::atomic<unsigned> traceEpoch{0};
+std::mutex exportMutex;
+
+void freeChain(TraceChunk* chunk)
+{
+    while (chunk) {
+        TraceChunk* next = chunk->next.load(std::memory_order_relaxed);
+        delete chunk;
+        chunk = next;
+    }
+}
+
+// Marks the buffer of an exiting thread, so a clear can free its events
+struct BufferOwner
+{
+    ThreadBuffer* buffer = nullptr;
+    ~BufferOwner()
+    {
+        if (buffer) buffer->finished.store(true, std::memory_order_release);
+    }
+};
+
+ThreadBuffer& localBuffer()
+{
+    thread_local BufferOwner owner;
+    ThreadBuffer*& buffer = owner.buffer;
+    if (!buffer) {
+        buffer = new ThreadBuffer;
+        buffer->epoch = traceEpoch.load(std::memory_order_relaxed);
+        buffer->id = threadCount.fetch_add(1, std::memory_order_relaxed) + 1;
+        ThreadBuffer* head = allBuffers.load(std::memory_order_relaxed);
+        do {
+            buffer->nextBuffer = head;
+        } while (!allBuffers.compare_exchange_weak(head, buffer, std::memory_order_release,
+                                                   std::memory_order_relaxed));
+    }
+    return *buffer;
+}
+
+// Owner only: swaps in an empty chain and hands the old one to freeRetired()
+void rewind(ThreadBuffer& buffer, unsigned epoch)
+{
+    TraceChunk* fresh = new TraceChunk;
+    TraceChunk* old = buffer.head.exchange(fresh, std::memory_order_acq_rel);
+    buffer.tail = fresh;
+    buffer.chunkCount = 1;
+    buffer.epoch = epoch;
+    buffer.dropped.store(0, std::memory_order_relaxed);
+    TraceChunk* retired = buffer.retired.load(std::memory_order_relaxed);
+    do {
+        old->nextRetired = retired;
+    } while (!buffer.retired.compare_exchange_weak(retired, old, std::memory_order_release,
+                                                  std::memory_order_relaxed));
+}
+
+// Caller holds exportMutex. Buffers of exited threads are emptied here,
+// since no owner is left to rewind them.
+void freeRetired(bool clearFinished)
+{
+    for (ThreadBuffer* buffer = allBuffers.load(std::memory_order_acquire); buffer; buffer = buffer->nextBuffer) {
+        TraceChunk* chain = buffer->retired.exchange(nullptr, std::memory_order_acquire);
+        while (chain) {
+            TraceChunk* nextChain = chain->nextRetired;
+            freeChain(chain);
+            chain = nextChain;
+        }
+        if (clearFinished && buffer->finished.load(std::memory_order_acquire)) {
+            freeChain(buffer->head.exchange(nullptr, std::memory_order_acq_rel));
+            buffer->dropped.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+void writeString(std::ostream& out, const char* text)
+{
+    out << '"';
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') out << '\\';
+        out << *c;
+    }
+    out << '"';
+}
+
+void writeMicroseconds(std::ostream& out, int64_t ns)
+{
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.3f", ns / 1000.0);
+    out << text;
+}
+
+} // namespace
+
+void setTraceEnabled(bool enabled)
+{
+    traceRecording.store(enabled, std::memory_order_relaxed);
+}
+
+void setTraceThreadName(const char* name)
+{
+    localBuffer().name.store(name, std::memory_order_release);
+}
+
+void clearTrace()
+{
+    std::lock_guard<std::mutex> lock(exportMutex);
+    clearedAtNs.store(traceClockNs(), std::memory_order_relaxed);
+    traceEpoch.fetch_add(1, std::memory_order_relaxed);
+    freeRetired(true);
+}
+
+int64_t traceClockNs()
+{
+    static const auto epoch = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void recordTraceEvent(const char* name, const char* category, int64_t startNs, int64_t durationNs)
+{
+    ThreadBuffer& buffer = localBuffer();
+    const unsigned epoch = traceEpoch.load(std::memory_order_relaxed);
+    if (buffer.epoch != epoch) rewind(buffer, epoch);
+    TraceChunk* chunk = buffer.tail;
+    int slot = chunk->count.load(std::memory_order_relaxed);
+    if (slot == TraceChunk::capacity) {
+        if (buffer.chunkCount == kMaxChunksPerThread) {
+            buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        TraceChunk* fresh = new TraceChunk;
+        chunk->next.store(fresh, std::memory_order_release);
+        buffer.tail = chunk = fresh;
+        buffer.chunkCount++;
+        slot = 0;
+    }
+    chunk->events[slot] = {name, category, startNs, durationNs};
+    chunk->count.store(slot + 1, std::memory_order_release);
+}
+
+size_t exportTraceJson(std::ostream& out)
+{
+    std::lock_guard<std::mutex> lock(exportMutex);
+    freeRetired(false);
+    const int64_t since = clearedAtNs.load(std::memory_order_relaxed);
+    size_t written = 0;
+    bool first = true;
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (ThreadBuffer* buffer = allBuffers.load(std::memory_order_acquire); buffer; buffer = buffer->nextBuffer) {
+        // Exited threads emptied by a clear have nothing left to show
+        TraceChunk* head = buffer->head.load(std::memory_order_acquire);
+        if (!head) continue;
+
+        // Thread label, then the events of that thread
+        out << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id
+            << ",\"args\":{\"name\":";
+        const char* name = buffer->name.load(std::memory_order_acquire);
+        if (name) {
+            writeString(out, name);
+        } else {
+            out << "\"Thread " << buffer->id << "\"";
+        }
+        out << "}}";
+        first = false;
+
+        for (TraceChunk* chunk = head; chunk; chunk = chunk->next.load(std::memory_order_acquire)) {
+            const int count = chunk->count.load(std::memory_order_acquire);
+            for (int i = 0; i < count; ++i) {
+                const TraceEvent& event = chunk->events[i];
+                if (event.startNs < since) continue;
+                out << ",\n{\"name\":";
+                writeString(out, event.name);
+                out << ",\"cat\":";
+                writeString(out, event.category);
+                out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->id << ",\"ts\":";
+                writeMicroseconds(out, event.startNs);
+                out << ",\"dur\":";
+                writeMicroseconds(out, event.durationNs);
+                out << "}";
+                written++;
+            }
+        }
+
+        const long long dropped = buffer->dropped.load(std::memory_order_relaxed);
+        if (dropped > 0) {
+            out << ",\n{\"name\":\"dropped events\",\"ph\":\"C\",\"pid\":1,\"tid\":" << buffer->id << ",\"ts\":0"
+                << ",\"args\":{\"dropped\":" << dropped << "}}";
+        }
+    }
+    out << "\n]}\n";
+    return written;
+}
+
+long long droppedTraceEvents()
+{
+    long long dropped = 0;
+    for (ThreadBuffer* buffer = allBuffers.load(std::memory_order_acquire); buffer; buffer = buffer->nextBuffer)
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+    return dropped;
+}
@@ -0,0 +1,83 @@
+#include "TrialRunner.h"
+#include "GridGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+SampleSummary summarizeSamples(std::vector<double> samples)
+{
+    SampleSummary summary;
+    if (samples.empty()) return summary;
+    std::sort(samples.begin(), samples.end());
+
+    const size_t n = samples.size();
+    summary.count = static_cast<int>(n);
+    summary.min = samples.front();
+    summary.median = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2.0;
+    summary.p95 = samples[static_cast<size_t>(std::ceil(0.95 * n)) - 1];
+
+    double sum = 0.0;
+    for (double value : samples) sum += value;
+    summary.mean = sum / n;
+    double squares = 0.0;
+    for (double value : samples) squares += (value - summary.mean) * (value - summary.mean);
+    summary.stddev = n > 1 ? std::sqrt(squares / (n - 1)) : 0.0;
+    return summary;
+}
+
+TrialReport runTrials(const SolverEntry& solver, const GridSnapshot& grid, const TrialOptions& options,
+                      const std::function<bool(int, int)>& progress)
+{
+    TrialReport report;
+    const int instances = options.sweep == SWEEP_NONE ? 1 : std::max(1, options.sweepCount);
+    const int runsPerInstance = std::max(0, options.warmupRuns) + std::max(1, options.runs);
+    const int total = instances * runsPerInstance;
+
+    std::mt19937 rng(options.seed);
+    std::vector<int> freeCells;
+    if (options.sweep == SWEEP_ENDPOINTS) {
+        for (int cell = 0; cell < grid.cellCount(); ++cell)
+            if (!grid.obstacle[cell]) freeCells.push_back(cell);
+    }
+
+    std::vector<double> times;
+    std::vector<double> expansions;
+    std::vector<double> pathLengths;
+    std::vector<double> memory;
+    GridSnapshot instance = grid;
+    SearchContext context;
+    int done = 0;
+
+    for (int i = 0; i < instances && !report.cancelled; ++i) {
+        if (options.sweep == SWEEP_ENDPOINTS && freeCells.size() >= 2) {
+            instance.startIndex = freeCells[rng() % freeCells.size()];
+            instance.endIndex = freeCells[rng() % freeCells.size()];
+        } else if (options.sweep == SWEEP_MAZES) {
+            carveMaze(instance, rng());
+        }
+        report.instances++;
+
+        for (int run = 0; run < runsPerInstance; ++run) {
+            const SearchResult& result = context.run(solver, instance, instance.startIndex, instance.endIndex);
+            if (run >= runsPerInstance - std::max(1, options.runs)) {
+                times.push_back(static_cast<double>(result.timeElapsedNs));
+                expansions.push_back(result.nodesVisited);
+                memory.push_back(static_cast<double>(result.memoryBytes));
+                if (!result.path.empty()) {
+                    report.pathsFound++;
+                    pathLengths.push_back(result.pathLength);
+                }
+            }
+            if (progress && !progress(++done, total)) {
+                report.cancelled = true;
+                break;
+            }
+        }
+    }
+
+    report.timeNs = summarizeSamples(times);
+    report.nodesVisited = summarizeSamples(expansions);
+    report.pathLength = summarizeSamples(pathLengths);
+    report.memoryBytes = summarizeSamples(memory);
+    return report;
+}
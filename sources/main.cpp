@@ -2,10 +2,23 @@
 #include "mainWindow.h"
 #include "GridView.h"
 #include "PathAlgorithm.h"
+#include "BatchRunner.h"
+#include "DatasetGenerator.h"
+#include <iostream>
 
 
 int main(int argc, char *argv[])
 {
+    // Headless batch mode: no window is created
+    BatchOptions batchOptions;
+    if (parseBatchOptions(argc, argv, batchOptions))
+        return runBatch(batchOptions, std::cout);
+
+    // Headless maze dataset mode
+    DatasetOptions datasetOptions;
+    if (parseDatasetOptions(argc, argv, datasetOptions))
+        return runDataset(datasetOptions, std::cout);
+
     // Starting a new QApplication
     QApplication a(argc, argv);
 
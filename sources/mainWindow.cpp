@@ -3,9 +3,22 @@
 #include <QMessageBox>
 #include <QLabel>
 #include <QTime>
+#include <QDateTime>
+#include <QFileDialog>
+#include <QPromise>
+#include <fstream>
+#include <memory>
 #include "mainWindow.h"
+#include "TraceEvents.h"
 #include "ui_mainWindow.h"
 
+namespace {
+
+// Speed spin box values that set the tick interval (kTimerSpeeds / value ms)
+const int kTimerSpeeds = 100;
+
+} // namespace
+
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
@@ -40,9 +53,10 @@ MainWindow::MainWindow(QWidget *parent)
     ui->sliderMarker->setValue(gridView.markerSize);
     ui->lcdMarker->display(gridView.markerSize);
 
-    // Simulation speed
-    ui->speedSpinBox->setMaximum(100);
-    int speed = ui->speedSpinBox->maximum() / 5;
+    // Simulation speed: up to kTimerSpeeds the tick interval shrinks, past it
+    // each 1 ms tick advances more units (on_speedSpinBox_valueChanged)
+    ui->speedSpinBox->setMaximum(kTimerSpeeds + 100);
+    int speed = kTimerSpeeds / 5;
     ui->speedSpinBox->setValue(speed);
 
     // Run button initial state
@@ -97,6 +111,27 @@ MainWindow::MainWindow(QWidget *parent)
             this, &MainWindow::on_deleteSelectedRowButton_clicked);
 
     mazeCurrentlyGenerated = false;
+
+    // Race mode
+    setupRaceControls();
+
+    // Incremental replanning when the grid is edited after a search
+    replanPending = false;
+    connect(&gridView, &GridView::cellObstacleChanged,
+            this, &MainWindow::onCellObstacleChanged);
+    connect(&gridView, &GridView::cellCostChanged,
+            this, &MainWindow::onCellCostChanged);
+    connect(&gridView, &GridView::endpointMoved,
+            this, &MainWindow::onEndpointMoved);
+
+    // Flow field overlay
+    setupFlowFieldControls();
+
+    // Timeline recording for chrome://tracing
+    setupTraceControls();
+
+    // Repeated-trial benchmark of one solver
+    setupBenchmarkControls();
 }
 
 MainWindow::~MainWindow()
@@ -112,6 +147,7 @@ void MainWindow::setupInteractionComboBox()
     ui->interactionBox->addItem("Add Start");
     ui->interactionBox->addItem("Add Goal");
     ui->interactionBox->addItem("Add Obstacles");
+    ui->interactionBox->addItem("Paint Terrain");
 }
 
 void MainWindow::setupAlgorithmsComboBox()
@@ -147,10 +183,13 @@ void MainWindow::setupGridView(QString gridViewName)
 
 void MainWindow::setupComparisonTable()
 {
-    ui->comparisonTable->setColumnCount(8);
     QStringList headers;
-    headers << "Algorithm" << "Time (s)" << "Nodes Visited" << "Path Length"
-            << "Grid Size" << "Wall Density" << "Dead Ends" << "Branching Factor";
+    headers << "Algorithm" << "Time (s)" << "Setup (ms)" << "Search (ms)" << "Path (ms)"
+            << "Nodes Visited" << "Path Length" << "Path Cost" << "LOS Checks"
+            << "Pushes" << "Pops" << "Stale Pops" << "Relaxations" << "Decrease-Keys" << "Peak Open" << "Peak Memory (KB)"
+            << "Cycles" << "Instructions" << "Cache Misses" << "Branch Misses"
+            << "Grid Size" << "Wall Density" << "Dead Ends" << "Branching Factor" << "Memory (KB)";
+    ui->comparisonTable->setColumnCount(headers.size());
     ui->comparisonTable->setHorizontalHeaderLabels(headers);
     ui->comparisonTable->horizontalHeader()->setStretchLastSection(true);
     ui->comparisonTable->setSelectionBehavior(QAbstractItemView::SelectRows);
@@ -159,17 +198,54 @@ void MainWindow::setupComparisonTable()
 
 void MainWindow::updateComparisonTable()
 {
+    TRACE_SCOPE("update comparison table", "gui");
     ui->comparisonTable->setRowCount(comparisonDataList.size());
     for (int i = 0; i < comparisonDataList.size(); ++i) {
         const AlgorithmComparisonData& data = comparisonDataList.at(i);
-        ui->comparisonTable->setItem(i, 0, new QTableWidgetItem(data.algorithmName));
-        ui->comparisonTable->setItem(i, 1, new QTableWidgetItem(QString::number(data.timeElapsedMs / 1000.0, 'f', 3)));
-        ui->comparisonTable->setItem(i, 2, new QTableWidgetItem(QString::number(data.nodesVisited)));
-        ui->comparisonTable->setItem(i, 3, new QTableWidgetItem(QString::number(data.pathLength)));
-        ui->comparisonTable->setItem(i, 4, new QTableWidgetItem(data.gridSize));
-        ui->comparisonTable->setItem(i, 5, new QTableWidgetItem(QString::number(data.wallDensity, 'f', 4)));
-        ui->comparisonTable->setItem(i, 6, new QTableWidgetItem(QString::number(data.numDeadEnds)));
-        ui->comparisonTable->setItem(i, 7, new QTableWidgetItem(QString::number(data.branchingFactor, 'f', 4)));
+        int column = 0;
+        auto add = [&](const QString& text) {
+            ui->comparisonTable->setItem(i, column++, new QTableWidgetItem(text));
+        };
+
+        // Phases are only known for runs the solver timed itself
+        const SearchTiming& timing = data.timing;
+        const bool timed = timing.totalNs() > 0;
+        auto milliseconds = [timed](long long ns) { return timed ? QString::number(ns / 1e6, 'f', 3) : QString("-"); };
+        add(data.algorithmName);
+        add(QString::number(data.timeElapsedNs / 1e9, 'f', 6));
+        add(milliseconds(timing.setupNs));
+        add(milliseconds(timing.searchNs));
+        add(milliseconds(timing.reconstructNs));
+
+        add(QString::number(data.nodesVisited));
+        add(data.pathLength >= 0 ? QString::number(data.pathLength) : "-");
+        add(data.pathCost > 0 ? QString::number(data.pathCost, 'f', 2) : "-");
+        add(data.lineOfSightChecks > 0 ? QString::number(data.lineOfSightChecks) : "-");
+
+        // Search counters, "-" for runs that do not count (or a nostats build)
+        const SearchStats& stats = data.stats;
+        const bool counted = stats.pushes > 0;
+        auto counter = [](bool known, long long value) { return known ? QString::number(value) : QString("-"); };
+        add(counter(counted, stats.pushes));
+        add(counter(counted, stats.pops));
+        add(counter(counted, stats.stalePops));
+        add(counter(counted, stats.relaxations));
+        add(counter(counted, stats.decreaseKeys));
+        add(counter(counted, static_cast<long long>(stats.peakOpen)));
+        add(counted ? QString::number(stats.peakMemoryBytes / 1024.0, 'f', 1) : "-");
+
+        // Hardware counters, "-" where perf_event_open is not available
+        const HardwareCounters& hardware = timing.hardware;
+        add(counter(hardware.valid, hardware.cycles));
+        add(counter(hardware.valid, hardware.instructions));
+        add(counter(hardware.valid, hardware.cacheMisses));
+        add(counter(hardware.valid, hardware.branchMisses));
+
+        add(data.gridSize);
+        add(QString::number(data.wallDensity, 'f', 4));
+        add(QString::number(data.numDeadEnds));
+        add(QString::number(data.branchingFactor, 'f', 4));
+        add(data.memoryBytes >= 0 ? QString::number(data.memoryBytes / 1024.0, 'f', 1) : "-");
     }
 }
 
@@ -180,6 +256,7 @@ GridView& MainWindow::getGridView()
 
 void MainWindow::on_runButton_clicked()
 {
+    TRACE_SCOPE("run button", "gui");
     if (ui->algorithmsBox->currentIndex() == -1) {
         QMessageBox::information(this, "Information", "Please select a path finding algorithm");
         ui->runButton->setChecked(false);
@@ -206,6 +283,28 @@ void MainWindow::on_runButton_clicked()
             animationTimer->start();
         }
     } else {
+        // Walled-off goal: answer from the component index instead of flooding the region
+        if (pathAlgorithm.getCurrentAlgorithm() == DIJKSTRA && !goalReachable()) {
+            ui->runButton->setChecked(false);
+            ui->runButton->setText("Start PathFinding");
+            ui->statusbar->showMessage("No path: start and goal are in different regions", 5000);
+
+            AlgorithmComparisonData data;
+            data.algorithmName = "Dijkstra (Pathfinding)";
+            data.timeElapsedNs = 0;
+            data.nodesVisited = 0;
+            data.pathLength = 0;
+            data.gridSize = QString("%1x%2").arg(gridView.widthGrid).arg(gridView.heightGrid);
+            const MazeFeatureIndex& features = mazeFeatures();
+            data.wallDensity = features.wallDensity();
+            data.numDeadEnds = features.deadEnds();
+            data.branchingFactor = features.branchingFactor();
+            data.memoryBytes = 0;
+            comparisonDataList.append(data);
+            updateComparisonTable();
+            return;
+        }
+
         pathAlgorithm.running = true;
         pathAlgorithm.simulationOnGoing = true;
 
@@ -230,6 +329,7 @@ void MainWindow::on_runButton_clicked()
 
 void MainWindow::on_resetButton_clicked()
 {
+    TRACE_SCOPE("reset grid", "gui");
     gridView.populateGridMap(gridView.getCurrentArrangement(), true);
 
     pathAlgorithm.running = false;
@@ -244,6 +344,11 @@ void MainWindow::on_resetButton_clicked()
     ui->algorithmsBox->setCurrentIndex(-1);
 
     mazeCurrentlyGenerated = false;
+    replanner.clear();
+    componentIndex.clear();
+    featureIndex.clear();
+    resetPreparedSolvers();
+    flowFieldBox->setChecked(false);
 
     animationTimer->stop();
     timeDisplayLabel->setText("Time: 0.000 s");
@@ -257,6 +362,12 @@ void MainWindow::on_mazeButton_clicked()
 
 void MainWindow::generateMazeWithAlgorithm(int algorithmEnum)
 {
+    TRACE_SCOPE("generate maze", "gui");
+    replanner.clear();
+    componentIndex.clear();
+    featureIndex.clear();
+    resetPreparedSolvers();
+    flowFieldBox->setChecked(false);
     pathAlgorithm.setCurrentAlgorithm(static_cast<ALGOS>(algorithmEnum));
     gridView.setCurrentAlgorithm(algorithmEnum);
 
@@ -295,6 +406,7 @@ void MainWindow::on_algorithmsBox_currentIndexChanged(int index)
 
 void MainWindow::onAlgorithmCompleted()
 {
+    TRACE_SCOPE("algorithm completed", "gui");
     gridView.setSimulationRunning(false);
     pathAlgorithm.setSimulationOnGoing(false);
     pathAlgorithm.running = false;
@@ -303,11 +415,18 @@ void MainWindow::onAlgorithmCompleted()
 
     if (pathAlgorithm.getCurrentAlgorithm() == BACKTRACK) {
         mazeCurrentlyGenerated = true;
+        // The carved cells bypass cellObstacleChanged, count them afresh
+        featureIndex.clear();
+    } else if (pathAlgorithm.getCurrentAlgorithm() == DIJKSTRA) {
+        // Seed the incremental planner with the grid that was just solved
+        replanner.reset(snapshotFromGrid(gridView.gridNodes, gridView.widthGrid, gridView.heightGrid));
+        replanner.computePath();
     }
 }
 
 void MainWindow::onPathfindingSearchCompleted(int nodesVisited, int pathLength)
 {
+    TRACE_SCOPE("search completed", "gui");
     animationTimer->stop();
     qint64 totalElapsed = pausedTimeOffset + elapsedTimer.elapsed();
 
@@ -319,13 +438,18 @@ void MainWindow::onPathfindingSearchCompleted(int nodesVisited, int pathLength)
     } else {
         data.algorithmName = "Unknown";
     }
-    data.timeElapsedMs = totalElapsed;
+    // Searches report the stepper's own time, without the animation around it;
+    // maze generation is timed on the wall clock
+    data.timing = pathAlgorithm.lastSearchTiming;
+    data.timeElapsedNs = data.timing.totalNs() > 0 ? data.timing.totalNs() : totalElapsed * 1000000;
     data.nodesVisited = nodesVisited;
     data.pathLength = pathLength;
+    data.stats = pathAlgorithm.lastSearchStats;
     data.gridSize = QString("%1x%2").arg(gridView.widthGrid).arg(gridView.heightGrid);
     data.wallDensity = 0.0;
     data.numDeadEnds = 0;
     data.branchingFactor = 0.0;
+    data.memoryBytes = 0;
 
     comparisonDataList.append(data);
     updateComparisonTable();
@@ -335,21 +459,501 @@ void MainWindow::onPathfindingSearchCompleted(int nodesVisited, int pathLength)
 
 void MainWindow::extractAndExportMazeFeatures(int nodesVisited, int pathLength)
 {
+    TRACE_SCOPE("maze features", "gui");
     Q_UNUSED(nodesVisited);
     Q_UNUSED(pathLength);
 
     if (comparisonDataList.isEmpty()) return;
 
     AlgorithmComparisonData& current = comparisonDataList.last();
-    current.wallDensity = gridView.calculateWallDensity();
-    current.numDeadEnds = gridView.countDeadEnds();
-    current.branchingFactor = gridView.calculateBranchingFactor();
+    const MazeFeatureIndex& features = mazeFeatures();
+    current.wallDensity = features.wallDensity();
+    current.numDeadEnds = features.deadEnds();
+    current.branchingFactor = features.branchingFactor();
 
     updateComparisonTable();
 
     // CSV export removed as per requirements.
 }
 
+void MainWindow::setupRaceControls()
+{
+    raceGeneration = 0;
+    preparedEdits = 0;
+    raceView = new RaceView(this);
+
+    raceList = new QListWidget(this);
+    for (const SolverEntry& entry : solverRegistry()) {
+        QListWidgetItem* item = new QListWidgetItem(QString::fromStdString(entry.name), raceList);
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState(Qt::Checked);
+    }
+    // Preprocessing solvers are listed after the plain ones, unchecked
+    for (const std::string& name : preparedSolverNames()) {
+        QListWidgetItem* item = new QListWidgetItem(QString::fromStdString(name), raceList);
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState(Qt::Unchecked);
+        preparedSolvers.push_back(std::shared_ptr<PreparedSolver>(createPreparedSolver(name)));
+    }
+    raceList->setMaximumHeight(90);
+    ui->verticalLayout_2->addWidget(raceList);
+
+    QPushButton* raceButton = new QPushButton("Race Selected Algorithms", this);
+    ui->verticalLayout_2->addWidget(raceButton);
+    connect(raceButton, &QPushButton::clicked,
+            this, &MainWindow::on_raceButton_clicked);
+}
+
+void MainWindow::on_raceButton_clicked()
+{
+    TRACE_SCOPE("start race", "gui");
+    if (pathAlgorithm.simulationOnGoing) {
+        QMessageBox::information(this, "Information", "Please stop the simulation first");
+        return;
+    }
+
+    QList<int> selected;
+    QStringList runNames;
+    for (int row = 0; row < raceList->count(); ++row) {
+        if (raceList->item(row)->checkState() == Qt::Checked) {
+            selected.append(row);
+            runNames.append(raceList->item(row)->text());
+        }
+    }
+    if (selected.isEmpty()) {
+        QMessageBox::information(this, "Race", "Please select at least one algorithm to race.");
+        return;
+    }
+
+    const bool reachable = goalReachable();
+
+    // Every run reads the same immutable snapshot and owns its scratch buffers
+    auto snapshot = std::make_shared<const GridSnapshot>(
+        snapshotFromGrid(gridView.gridNodes, gridView.widthGrid, gridView.heightGrid));
+
+    const int generation = ++raceGeneration;
+    raceView->startRace(*snapshot, runNames);
+    raceView->show();
+    raceView->raise();
+
+    const QString gridSize = QString("%1x%2").arg(gridView.widthGrid).arg(gridView.heightGrid);
+    const qreal wallDensity = mazeFeatures().wallDensity();
+    const int numDeadEnds = mazeFeatures().deadEnds();
+    const qreal branchingFactor = mazeFeatures().branchingFactor();
+
+    const int registrySize = static_cast<int>(solverRegistry().size());
+    for (int run = 0; run < selected.size(); ++run) {
+        const int row = selected[run];
+        const SolverEntry entry = row < registrySize ? solverRegistry()[row] : SolverEntry{"", nullptr};
+        const QString name = runNames[run];
+
+        // Tables are built on the first race after an invalidating change and
+        // then kept in sync with grid edits; the race itself only queries.
+        // Building runs on the pool as the first step of the run's task.
+        std::shared_ptr<const PreparedSolver> prepared;
+        std::shared_ptr<PreparedSolver> building;
+        const int slot = row - registrySize;
+        if (row >= registrySize) {
+            if (preparedSolvers[slot]->isPrepared())
+                prepared = preparedSolvers[slot];
+            else
+                building = std::shared_ptr<PreparedSolver>(createPreparedSolver(preparedSolvers[slot]->name()));
+        }
+        const int edits = preparedEdits;
+
+        auto* watcher = new QFutureWatcher<SearchResult>(this);
+        connect(watcher, &QFutureWatcher<SearchResult>::finished, this,
+                [=]() {
+            TRACE_SCOPE("race result", "gui");
+            SearchResult result = watcher->result();
+            if (generation == raceGeneration)
+                raceView->showResult(run, result);
+
+            if (building && building->isPrepared()) {
+                ui->statusbar->showMessage(QString("%1 preprocessing: %2 ms, %3 KB, %4")
+                                           .arg(name)
+                                           .arg(building->prepareNs() / 1e6, 0, 'f', 2)
+                                           .arg(qulonglong(building->memoryBytes() / 1024))
+                                           .arg(QString::fromStdString(building->statistics())));
+                // Kept for later races only if the grid is still the one it was built for
+                if (edits == preparedEdits && !preparedSolvers[slot]->isPrepared())
+                    preparedSolvers[slot] = building;
+            }
+
+            AlgorithmComparisonData data;
+            data.algorithmName = name + " (Race)";
+            data.timeElapsedNs = result.timeElapsedNs;
+            data.nodesVisited = result.nodesVisited;
+            data.pathLength = result.pathLength;
+            data.pathCost = result.pathCost;
+            data.lineOfSightChecks = result.lineOfSightChecks;
+            data.stats = result.stats;
+            data.timing = result.timing;
+            data.gridSize = gridSize;
+            data.wallDensity = wallDensity;
+            data.numDeadEnds = numDeadEnds;
+            data.branchingFactor = branchingFactor;
+            data.memoryBytes = result.memoryBytes;
+            comparisonDataList.append(data);
+            updateComparisonTable();
+
+            watcher->deleteLater();
+        });
+
+        watcher->setFuture(QtConcurrent::run(&pathAlgorithm.pool, [snapshot, entry, prepared, building, reachable]() {
+            std::shared_ptr<const PreparedSolver> solver = prepared;
+            if (building) {
+                TRACE_SCOPE("prepare solver", "solver");
+                building->prepare(*snapshot);
+                solver = building;
+            }
+            if (!reachable) return SearchResult();
+            TRACE_SCOPE(solver ? "race query (prepared)" : "race query", "solver");
+            SearchScratch scratch;
+            if (solver)
+                return solver->query(snapshot->startIndex, snapshot->endIndex, scratch);
+            return entry.run(*snapshot, snapshot->startIndex, snapshot->endIndex, scratch);
+        }));
+    }
+}
+
+bool MainWindow::goalReachable()
+{
+    if (!componentIndex.isBuilt())
+        componentIndex.build(snapshotFromGrid(gridView.gridNodes, gridView.widthGrid, gridView.heightGrid));
+    componentIndex.refresh();
+    return componentIndex.connected(gridView.gridNodes.startIndex, gridView.gridNodes.endIndex);
+}
+
+const MazeFeatureIndex& MainWindow::mazeFeatures()
+{
+    if (!featureIndex.isBuilt())
+        featureIndex.build(snapshotFromGrid(gridView.gridNodes, gridView.widthGrid, gridView.heightGrid));
+    return featureIndex;
+}
+
+void MainWindow::resetPreparedSolvers()
+{
+    preparedEdits++;
+    // A solver still used by a running race is swapped for a fresh instance
+    for (auto& solver : preparedSolvers) {
+        if (solver.use_count() > 1)
+            solver = std::shared_ptr<PreparedSolver>(createPreparedSolver(solver->name()));
+        else
+            solver->clear();
+    }
+}
+
+void MainWindow::onCellObstacleChanged(int index, bool obstacle)
+{
+    TRACE_SCOPE("cell edited", "gui");
+    componentIndex.setObstacle(index, obstacle);
+    featureIndex.setObstacle(index, obstacle);
+
+    // Prepared tables are patched in place unless a race is still reading them
+    preparedEdits++;
+    for (auto& solver : preparedSolvers) {
+        if (solver.use_count() > 1)
+            solver = std::shared_ptr<PreparedSolver>(createPreparedSolver(solver->name()));
+        else if (solver->isPrepared())
+            solver->setObstacle(index, obstacle);
+    }
+
+    if (flowFieldBox->isChecked() && !flowPending) {
+        flowPending = true;
+        QTimer::singleShot(0, this, &MainWindow::refreshFlowField);
+    }
+
+    if (!replanner.isInitialised()) return;
+    replanner.setObstacle(index, obstacle);
+    if (!replanPending) {
+        replanPending = true;
+        QTimer::singleShot(0, this, &MainWindow::replanAfterEdit);
+    }
+}
+
+void MainWindow::onCellCostChanged(int index, int cost)
+{
+    TRACE_SCOPE("cell cost edited", "gui");
+    // The prepared solvers, the flow field and the component and feature
+    // indexes count steps, so only the replanner sees terrain edits
+    if (!replanner.isInitialised()) return;
+    replanner.setCost(index, cost);
+    if (!replanPending) {
+        replanPending = true;
+        QTimer::singleShot(0, this, &MainWindow::replanAfterEdit);
+    }
+}
+
+void MainWindow::onEndpointMoved(INTERACTIONS endpoint, int index)
+{
+    TRACE_SCOPE("endpoint moved", "gui");
+    if (flowFieldBox->isChecked() && !flowPending) {
+        flowPending = true;
+        QTimer::singleShot(0, this, &MainWindow::refreshFlowField);
+    }
+
+    if (!replanner.isInitialised()) return;
+    if (endpoint == START)
+        replanner.setStart(index);
+    else if (endpoint == END)
+        replanner.setGoal(index);
+    if (!replanPending) {
+        replanPending = true;
+        QTimer::singleShot(0, this, &MainWindow::replanAfterEdit);
+    }
+}
+
+void MainWindow::replanAfterEdit()
+{
+    TRACE_SCOPE("replan after edit", "gui");
+    replanPending = false;
+    if (!replanner.isInitialised() || pathAlgorithm.simulationOnGoing) return;
+
+    // Unreachable goal: keep the pending repairs queued and skip the search
+    SearchResult result;
+    if (goalReachable())
+        result = replanner.computePath();
+
+    // Redraw the path line from the repaired result
+    gridView.pathLine->clear();
+    for (size_t i = 0; i < result.path.size(); ++i) {
+        int idx = result.path[i];
+        gridView.handleUpdatedLineGridView(QPointF(idx % gridView.widthGrid + 1, idx / gridView.widthGrid + 1), true, i == 0);
+    }
+
+    AlgorithmComparisonData data;
+    data.algorithmName = "LPA* (Replan)";
+    data.timeElapsedNs = result.timeElapsedNs;
+    data.nodesVisited = result.nodesVisited;
+    data.pathLength = result.pathLength;
+    data.pathCost = result.pathCost;
+    data.stats = result.stats;
+    data.gridSize = QString("%1x%2").arg(gridView.widthGrid).arg(gridView.heightGrid);
+    data.wallDensity = mazeFeatures().wallDensity();
+    data.numDeadEnds = mazeFeatures().deadEnds();
+    data.branchingFactor = mazeFeatures().branchingFactor();
+    data.memoryBytes = result.memoryBytes;
+
+    // One row follows the edits: the previous replan row is overwritten
+    int row = comparisonDataList.size() - 1;
+    while (row >= 0 && comparisonDataList.at(row).algorithmName != data.algorithmName)
+        --row;
+    if (row >= 0)
+        comparisonDataList[row] = data;
+    else
+        comparisonDataList.append(data);
+    updateComparisonTable();
+}
+
+void MainWindow::setupFlowFieldControls()
+{
+    flowPending = false;
+    flowFieldBox = new QCheckBox("Show Flow Field", this);
+    ui->verticalLayout_2->addWidget(flowFieldBox);
+    connect(flowFieldBox, &QCheckBox::toggled,
+            this, &MainWindow::onFlowFieldToggled);
+}
+
+void MainWindow::setupTraceControls()
+{
+    setTraceThreadName("GUI");
+    QCheckBox* traceBox = new QCheckBox("Record Trace", this);
+    ui->verticalLayout_2->addWidget(traceBox);
+    connect(traceBox, &QCheckBox::toggled, this, [](bool checked) {
+        // A new recording starts from an empty timeline
+        if (checked) clearTrace();
+        setTraceEnabled(checked);
+    });
+
+    QPushButton* exportTraceButton = new QPushButton("Export Trace...", this);
+    ui->verticalLayout_2->addWidget(exportTraceButton);
+    connect(exportTraceButton, &QPushButton::clicked,
+            this, &MainWindow::on_exportTraceButton_clicked);
+}
+
+void MainWindow::on_exportTraceButton_clicked()
+{
+    QString path = QFileDialog::getSaveFileName(this, "Export Trace", "trace.json", "Trace Event JSON (*.json)");
+    if (path.isEmpty()) return;
+
+    std::ofstream out(QFile::encodeName(path).constData());
+    size_t events = exportTraceJson(out);
+    if (!out) {
+        QMessageBox::warning(this, "Export Trace", "Cannot write " + path);
+        return;
+    }
+    QString message = QString("Exported %1 trace events, open them in chrome://tracing or ui.perfetto.dev")
+                          .arg(qulonglong(events));
+    const long long dropped = droppedTraceEvents();
+    if (dropped > 0) message += QString(" (trace buffer full, %1 events dropped)").arg(dropped);
+    ui->statusbar->showMessage(message, 5000);
+}
+
+void MainWindow::setupBenchmarkControls()
+{
+    benchmarkSolverBox = new QComboBox(this);
+    for (const SolverEntry& entry : solverRegistry())
+        benchmarkSolverBox->addItem(QString::fromStdString(entry.name));
+
+    benchmarkRunsBox = new QSpinBox(this);
+    benchmarkRunsBox->setRange(1, 1000);
+    benchmarkRunsBox->setValue(20);
+    benchmarkRunsBox->setPrefix("Runs: ");
+
+    // Order matches SWEEPMODES
+    benchmarkSweepBox = new QComboBox(this);
+    benchmarkSweepBox->addItem("Current start and goal");
+    benchmarkSweepBox->addItem("Random start/goal pairs");
+    benchmarkSweepBox->addItem("Generated mazes");
+
+    benchmarkSweepCountBox = new QSpinBox(this);
+    benchmarkSweepCountBox->setRange(1, 1000);
+    benchmarkSweepCountBox->setValue(10);
+    benchmarkSweepCountBox->setPrefix("Instances: ");
+    benchmarkSweepCountBox->setEnabled(false);
+    connect(benchmarkSweepBox, &QComboBox::currentIndexChanged, this, [this](int index) {
+        benchmarkSweepCountBox->setEnabled(index != SWEEP_NONE);
+    });
+
+    benchmarkButton = new QPushButton("Benchmark Algorithm", this);
+    benchmarkProgress = new QProgressBar(this);
+    benchmarkProgress->setValue(0);
+    benchmarkLabel = new QLabel(this);
+    benchmarkLabel->setWordWrap(true);
+
+    ui->verticalLayout_2->addWidget(benchmarkSolverBox);
+    ui->verticalLayout_2->addWidget(benchmarkRunsBox);
+    ui->verticalLayout_2->addWidget(benchmarkSweepBox);
+    ui->verticalLayout_2->addWidget(benchmarkSweepCountBox);
+    ui->verticalLayout_2->addWidget(benchmarkButton);
+    ui->verticalLayout_2->addWidget(benchmarkProgress);
+    ui->verticalLayout_2->addWidget(benchmarkLabel);
+    connect(benchmarkButton, &QPushButton::clicked,
+            this, &MainWindow::on_benchmarkButton_clicked);
+}
+
+void MainWindow::on_benchmarkButton_clicked()
+{
+    TRACE_SCOPE("start benchmark", "gui");
+    if (pathAlgorithm.simulationOnGoing) {
+        QMessageBox::information(this, "Information", "Please stop the simulation first");
+        return;
+    }
+
+    const SolverEntry entry = solverRegistry()[benchmarkSolverBox->currentIndex()];
+    TrialOptions options;
+    options.runs = benchmarkRunsBox->value();
+    options.sweep = static_cast<SWEEPMODES>(benchmarkSweepBox->currentIndex());
+    options.sweepCount = benchmarkSweepCountBox->value();
+    options.seed = static_cast<uint32_t>(QDateTime::currentMSecsSinceEpoch());
+    const int instances = options.sweep == SWEEP_NONE ? 1 : options.sweepCount;
+    const int totalRuns = instances * (options.warmupRuns + options.runs);
+
+    auto snapshot = std::make_shared<const GridSnapshot>(
+        snapshotFromGrid(gridView.gridNodes, gridView.widthGrid, gridView.heightGrid));
+    const QString name = QString::fromStdString(entry.name);
+    const QString gridSize = QString("%1x%2").arg(gridView.widthGrid).arg(gridView.heightGrid);
+
+    benchmarkButton->setEnabled(false);
+    benchmarkProgress->setRange(0, totalRuns);
+    benchmarkProgress->setValue(0);
+    benchmarkLabel->setText(QString("Benchmarking %1...").arg(name));
+
+    auto* watcher = new QFutureWatcher<TrialReport>(this);
+    connect(watcher, &QFutureWatcher<TrialReport>::progressValueChanged,
+            benchmarkProgress, &QProgressBar::setValue);
+    connect(watcher, &QFutureWatcher<TrialReport>::finished, this, [=]() {
+        TRACE_SCOPE("benchmark result", "gui");
+        benchmarkButton->setEnabled(true);
+        benchmarkProgress->setValue(totalRuns);
+        if (watcher->future().resultCount() == 0) {
+            watcher->deleteLater();
+            return;
+        }
+        const TrialReport report = watcher->result();
+        const SampleSummary& time = report.timeNs;
+        const SampleSummary& nodes = report.nodesVisited;
+        benchmarkLabel->setText(QString("%1: %2 timed runs on %3 instance(s), %4 with a path\n"
+                                        "Time (ms): min %5, median %6, p95 %7, std dev %8\n"
+                                        "Expansions: min %9, median %10, p95 %11, std dev %12")
+                                .arg(name).arg(time.count).arg(report.instances).arg(report.pathsFound)
+                                .arg(time.min / 1e6, 0, 'f', 3).arg(time.median / 1e6, 0, 'f', 3)
+                                .arg(time.p95 / 1e6, 0, 'f', 3).arg(time.stddev / 1e6, 0, 'f', 3)
+                                .arg(nodes.min, 0, 'f', 0).arg(nodes.median, 0, 'f', 0)
+                                .arg(nodes.p95, 0, 'f', 0).arg(nodes.stddev, 0, 'f', 1));
+
+        // The table gets the medians; the spread stays in the label above
+        AlgorithmComparisonData data;
+        data.algorithmName = QString("%1 (Benchmark, median of %2)").arg(name).arg(time.count);
+        data.timeElapsedNs = static_cast<qint64>(time.median);
+        data.nodesVisited = static_cast<int>(nodes.median);
+        // Medians over the timed runs; -1 shows "-" when no run found a path
+        data.pathLength = report.pathLength.count > 0 ? static_cast<int>(report.pathLength.median) : -1;
+        data.gridSize = gridSize;
+        data.wallDensity = mazeFeatures().wallDensity();
+        data.numDeadEnds = mazeFeatures().deadEnds();
+        data.branchingFactor = mazeFeatures().branchingFactor();
+        data.memoryBytes = report.memoryBytes.count > 0 ? static_cast<qint64>(report.memoryBytes.median) : -1;
+        comparisonDataList.append(data);
+        updateComparisonTable();
+
+        watcher->deleteLater();
+    });
+
+    watcher->setFuture(QtConcurrent::run(&pathAlgorithm.pool,
+                                         [snapshot, entry, options, totalRuns](QPromise<TrialReport>& promise) {
+        TRACE_SCOPE("benchmark trials", "solver");
+        promise.setProgressRange(0, totalRuns);
+        TrialReport report = runTrials(entry, *snapshot, options, [&promise](int done, int) {
+            promise.setProgressValue(done);
+            return !promise.isCanceled();
+        });
+        promise.addResult(report);
+    }));
+}
+
+void MainWindow::onFlowFieldToggled(bool checked)
+{
+    if (checked) {
+        refreshFlowField();
+    } else {
+        gridView.clearFlowField();
+        flowField.clear();
+    }
+}
+
+void MainWindow::refreshFlowField()
+{
+    TRACE_SCOPE("refresh flow field", "gui");
+    flowPending = false;
+    if (!flowFieldBox->isChecked() || pathAlgorithm.simulationOnGoing) return;
+
+    flowField.compute(snapshotFromGrid(gridView.gridNodes, gridView.widthGrid, gridView.heightGrid),
+                      gridView.gridNodes.endIndex);
+    gridView.showFlowField(flowField);
+
+    std::vector<int> path = flowField.pathFrom(gridView.gridNodes.startIndex);
+
+    AlgorithmComparisonData data;
+    data.algorithmName = "Flow Field";
+    data.timeElapsedNs = flowField.computeNs();
+    data.nodesVisited = flowField.reachableCells();
+    data.pathLength = path.empty() ? 0 : static_cast<int>(path.size()) - 1;
+    data.gridSize = QString("%1x%2").arg(gridView.widthGrid).arg(gridView.heightGrid);
+    data.wallDensity = mazeFeatures().wallDensity();
+    data.numDeadEnds = mazeFeatures().deadEnds();
+    data.branchingFactor = mazeFeatures().branchingFactor();
+    data.memoryBytes = flowField.memoryBytes();
+    comparisonDataList.append(data);
+    updateComparisonTable();
+
+    ui->statusbar->showMessage(QString("Flow field: %1 ms, %2 rounds, %3 reachable cells")
+                               .arg(flowField.computeNs() / 1e6, 0, 'f', 2)
+                               .arg(flowField.rounds())
+                               .arg(flowField.reachableCells()));
+}
+
 void MainWindow::on_dialWidth_valueChanged(int value)
 {
     ui->lcdWidth->display(value);
@@ -373,25 +977,45 @@ void MainWindow::on_sliderMarker_sliderReleased()
 
 void MainWindow::on_dialWidth_sliderReleased()
 {
+    TRACE_SCOPE("resize grid", "gui");
     gridView.widthGrid = ui->lcdWidth->value();
     gridView.populateGridMap(gridView.getCurrentArrangement(), true);
     mazeCurrentlyGenerated = false;
+    replanner.clear();
+    componentIndex.clear();
+    featureIndex.clear();
+    resetPreparedSolvers();
+    flowFieldBox->setChecked(false);
 }
 
 void MainWindow::on_dialHeight_sliderReleased()
 {
+    TRACE_SCOPE("resize grid", "gui");
     gridView.heightGrid = ui->lcdHeight->value();
     gridView.populateGridMap(gridView.getCurrentArrangement(), true);
     mazeCurrentlyGenerated = false;
+    replanner.clear();
+    componentIndex.clear();
+    featureIndex.clear();
+    resetPreparedSolvers();
+    flowFieldBox->setChecked(false);
 }
 
 void MainWindow::on_speedSpinBox_valueChanged(int arg1)
 {
-    pathAlgorithm.setSpeedVizualization(ui->speedSpinBox->maximum() / arg1);
+    if (arg1 <= kTimerSpeeds) {
+        pathAlgorithm.setSpeedVizualization(kTimerSpeeds / arg1);
+        pathAlgorithm.setStepsPerTick(1);
+    } else {
+        // Steps per tick double every 10 values: 2 at 110, 1024 at the top
+        pathAlgorithm.setSpeedVizualization(1);
+        pathAlgorithm.setStepsPerTick(1 << ((arg1 - kTimerSpeeds) / 10));
+    }
 }
 
 void MainWindow::updateElapsedTime()
 {
+    TRACE_SCOPE("elapsed time label", "gui");
     qint64 elapsed = pausedTimeOffset + elapsedTimer.elapsed();
     timeDisplayLabel->setText(QString("Time: %1 s").arg(elapsed / 1000.0, 0, 'f', 3));
 }